@@ -0,0 +1,125 @@
+#include <cstring>
+
+#include "BlockCache.h"
+
+BlockCache::BlockCache(uint32_t* version)
+{
+    mVersion = version;
+    *mVersion = 0;
+
+    memset(mCodeBytes, 0, sizeof(mCodeBytes));
+
+    for (int entry = 0; entry < LOOKUP_SIZE; entry++)
+        mLookup[entry] = { 0xFFFFFFFF, NULL };
+}
+
+// ROM bank 0 (0x0000-0x3FFF), the switchable ROM bank (0x4000-0x7FFF), work RAM (0xC000-0xFDFF) and high RAM (0xFF80-0xFFFE) are the
+// only places that code is cached from. code running from anywhere else (VRAM, cartridge RAM, etc.) is rare enough that it is just
+// interpreted one opcode at a time. an instruction that crosses from one region into another is never cached either
+bool BlockCache::isCacheable(DoubleByte first, DoubleByte last)
+{
+    if (last < first)
+        return false;
+
+    if (last <= 0x3FFF)
+        return true;
+    else if (first >= 0x4000 && last <= 0x7FFF)
+        return true;
+    else if (first >= 0xC000 && last <= 0xFDFF)
+        return true;
+
+    return first >= 0xFF80 && last <= 0xFFFE;
+}
+
+// the same address in the switchable ROM bank region can hold completely different code depending on which bank is selected,
+// so the bank becomes part of the key. anything in bank 0 or in RAM doesn't depend on the selected bank at all
+uint32_t BlockCache::makeKey(DoubleByte addr, DoubleByte romBank)
+{
+    if (addr <= 0x3FFF)
+        return addr;
+    else if (addr <= 0x7FFF)
+        return (uint32_t(romBank) << 16) | addr;
+
+    return (RAM_BANK << 16) | addr;
+}
+
+Block* BlockCache::findBlock(DoubleByte addr, DoubleByte romBank)
+{
+    uint32_t key = makeKey(addr, romBank);
+    LookupEntry& entry = mLookup[lookupIndex(key)];
+
+    // most of the time the block will be in the direct mapped table, which saves hashing into the map
+    if (entry.key == key)
+        return entry.block;
+
+    auto block = mBlocks.find(key);
+    if (block == mBlocks.end())
+        return NULL;
+
+    entry = { key, &block->second };
+    return entry.block;
+}
+
+Block* BlockCache::insertBlock(Block& block, DoubleByte romBank)
+{
+    uint32_t key = makeKey(block.startAddr, romBank);
+    Block* cachedBlock = &(mBlocks[key] = std::move(block));
+
+    // keep track of which bytes of RAM belong to the block, so that writing to them can throw it away
+    if (cachedBlock->startAddr >= 0xC000)
+        for (uint32_t addr = cachedBlock->startAddr; addr < cachedBlock->endAddr; addr++)
+            mCodeBytes[addr - 0xC000]++;
+
+    mLookup[lookupIndex(key)] = { key, cachedBlock };
+    return cachedBlock;
+}
+
+void BlockCache::removeBlock(uint32_t key)
+{
+    Block& block = mBlocks[key];
+
+    for (uint32_t addr = block.startAddr; addr < block.endAddr; addr++)
+        mCodeBytes[addr - 0xC000]--;
+
+    LookupEntry& entry = mLookup[lookupIndex(key)];
+    if (entry.key == key)
+        entry = { 0xFFFFFFFF, NULL };
+
+    mBlocks.erase(key);
+    (*mVersion)++;
+}
+
+// called when a byte that belongs to at least one block in RAM is written to
+void BlockCache::invalidate(DoubleByte addr)
+{
+    // a block is at most a few dozen bytes long, so only blocks that start a little before addr need to be checked
+    for (int start = addr; start >= 0xC000 && start > addr - 0x100; start--)
+    {
+        uint32_t key = makeKey(start, 0);
+        auto block = mBlocks.find(key);
+
+        if (block != mBlocks.end() && addr < block->second.endAddr)
+            removeBlock(key);
+    }
+}
+
+void BlockCache::clear()
+{
+    mBlocks.clear();
+
+    memset(mCodeBytes, 0, sizeof(mCodeBytes));
+
+    for (int entry = 0; entry < LOOKUP_SIZE; entry++)
+        mLookup[entry] = { 0xFFFFFFFF, NULL };
+
+    (*mVersion)++;
+}
+
+void BlockCache::invalidateRAM()
+{
+    for (uint32_t addr = 0xC000; addr <= 0xFFFF; addr++)
+        if (mBlocks.count(makeKey(addr, 0)))
+            removeBlock(makeKey(addr, 0));
+
+    (*mVersion)++;
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "Constants.h"
+
+class CPU;
+
+// every opcode is executed by a handler with this signature. the operand is the (up to 2 byte) value that follows the opcode
+typedef void (*OpcodeHandler)(CPU& cpu, DoubleByte operand);
+
+struct MicroOp;
+
+// a superinstruction runs several of the instructions that follow it in a block at once. it is given those instructions, the tick limit
+// and the block cache's version, and returns false if the block has to stop running (for the same reasons it would between instructions)
+typedef bool (*SuperinstructionHandler)(CPU& cpu, const MicroOp* ops, uint64_t maxTicks, uint32_t version);
+
+// a single instruction that has already been fetched and decoded, so that executing it again
+// doesn't require going through the MMU or the opcode tables
+struct MicroOp
+{
+    union
+    {
+        OpcodeHandler handler;                    // the handler that executes the instruction (for CB-prefixed opcodes, the CB handler itself)
+        SuperinstructionHandler superinstruction; // used instead when fusedOps isn't 0
+    };
+
+    DoubleByte operand;    // the operand that followed the opcode
+    Byte ticks;            // the number of ticks the instruction takes (0 if the handler adds them itself)
+    Byte length;           // the size of the instruction in bytes, including the opcode
+    Byte opcode;           // the original opcode (the interrupt handler still needs to know if it was a HALT)
+
+    // if this isn't 0, this isn't an instruction at all, but a superinstruction that runs the next fusedOps instructions of the block.
+    // those instructions are still kept in the block after it, for their operands and for the JIT
+    Byte fusedOps;
+};
+
+// a straight-line run of instructions, ending at the first instruction that can change the program counter
+struct Block
+{
+    DoubleByte startAddr;
+    DoubleByte endAddr; // the address right after the last byte of the block's last instruction
+    std::vector<MicroOp> ops;
+
+    // true if the block is a loop back to itself that only reads memory and compares what it read (waiting for an i/o register
+    // or a flag in RAM to change), meaning that it can be skipped ahead until something else changes that memory
+    bool idleLoop = false;
+
+#ifdef HERMES_JIT
+    uint32_t executions = 0;  // how many times the block has been ran by the interpreter
+    void* nativeCode = NULL;  // the block translated into native code by the JIT (NULL until it is hot enough)
+#endif
+};
+
+/*
+    the block cache holds decoded blocks of instructions keyed by the ROM bank and the address that they start at,
+    meaning that the same ROM code only ever has to be decoded once. code in work RAM and high RAM can be cached as well,
+    but since it can be overwritten, any write to a byte that belongs to a cached block throws that block away
+*/
+class BlockCache
+{
+private:
+    // the ROM bank used in the keys of blocks that live in RAM
+    static const uint32_t RAM_BANK = 0xFFFF;
+
+    // the size of the small direct mapped table that sits in front of the hash map (must be a power of 2)
+    static const int LOOKUP_SIZE = 4096;
+
+    struct LookupEntry
+    {
+        uint32_t key;
+        Block* block;
+    };
+
+    std::unordered_map<uint32_t, Block> mBlocks;
+    LookupEntry mLookup[LOOKUP_SIZE];
+
+    // the number of RAM blocks that each byte of work RAM and high RAM belongs to
+    Byte mCodeBytes[0x4000];
+
+    // incremented any time that a block is thrown away or the ROM bank is switched. the CPU uses this
+    // to know that the block it is in the middle of running is no longer valid (so it is kept in the CPU's core state)
+    uint32_t* mVersion;
+
+    static uint32_t makeKey(DoubleByte addr, DoubleByte romBank);
+    static int lookupIndex(uint32_t key) { return (key ^ (key >> 14)) & (LOOKUP_SIZE - 1); }
+
+    void removeBlock(uint32_t key);
+
+public:
+    BlockCache(uint32_t* version);
+
+    // the most instructions that a single block can hold. this keeps every block well under 0x100 bytes long
+    static const int MAX_BLOCK_LENGTH = 64;
+
+    // returns true if the bytes from first to last (inclusive) all lie in the same region of memory that code can be cached from
+    static bool isCacheable(DoubleByte first, DoubleByte last);
+
+    // returns the block starting at addr, or NULL if it has not been decoded yet
+    Block* findBlock(DoubleByte addr, DoubleByte romBank);
+
+    // stores a block that the CPU has just decoded, returning a pointer to the cached copy
+    Block* insertBlock(Block& block, DoubleByte romBank);
+
+    // returns true if the byte at addr belongs to a cached block in RAM (meaning that writing to it should invalidate the block)
+    bool containsCode(DoubleByte addr) { return addr >= 0xC000 && mCodeBytes[addr - 0xC000]; }
+
+    void invalidate(DoubleByte addr); // throws away any block in RAM containing the byte at addr
+    void invalidateRAM();             // throws away every block in RAM
+    void clear();                     // throws away every block
+    void onBankSwitch() { (*mVersion)++; }
+
+    uint32_t getVersion() { return *mVersion; }
+    const uint32_t* getVersionAddress() { return mVersion; }
+};
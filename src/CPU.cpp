@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -5,212 +6,474 @@
 #include <stdint.h>
 
 #include "CPU.h"
-
-// each element can be indexed by the opcode, and it will tell the CPU how big (in bytes) the operand it needs to read in is
-const Byte OPCODE_OPERAND_SIZE[256] =
-{
-    0, 2, 0, 0, 0, 0, 1, 0, 2, 0, 0, 0, 0, 0, 1, 0, // 0x0-0xF
-    1, 2, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, // 0x10-0x1F
-    1, 2, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, // 0x20-0x2F
-    1, 2, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 1, 0, // 0x30-0x3F
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x40-0x4F
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x50-0x5F
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x60-0x6F
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x70-0x7F
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x80-0x8F
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0x90-0x9F
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xA0-0xAF
-    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, // 0xB0-0xBF
-    0, 0, 2, 2, 2, 0, 1, 0, 0, 0, 2, 1, 2, 2, 1, 0, // 0xC0-0xCF
-    0, 0, 2, 0, 2, 0, 1, 0, 0, 0, 2, 0, 2, 0, 1, 0, // 0xD0-0xDF
-    1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 2, 0, 0, 0, 1, 0, // 0xE0-0xEF
-    1, 0, 0, 0, 0, 0, 1, 0, 1, 0, 2, 0, 0, 0, 1, 0, // 0xF0-0xFF
-};
-
-/* 
-    each element represents the number of ticks (clock cycles) that each instruction takes
-    when an element has a value of 0, it means that the number of ticks the opcode takes
-    is dependent on its operands
-
-    taken from: https://github.com/retrio/gb-test-roms/tree/master/instr_timing
-*/
-const Byte opcodeTicks[256] = {
-	4,  12, 8, 8,  4,  4,  8,  4,  20,  8,  8,  8, 4, 4,  8, 4, // 0x0-0xF
-	4,  12, 8, 8,  4,  4,  8,  4,   12, 8,  8,  8, 4, 4,  8, 4, // 0x10-0x1F
-	0,  12, 8, 8,  4,  4,  8,  4,   0,  8,  8,  8, 4, 4,  8, 4, // 0x20-0x2F
-	0,  12, 8, 8,  12, 12, 12, 4,   0,  8,  8,  8, 4, 4,  8, 4, // 0x30-0x3F
-	4,  4,  4, 4,  4,  4,  8,  4,   4,  4,  4,  4, 4, 4,  8, 4, // 0x40-0x4F
-	4,  4,  4, 4,  4,  4,  8,  4,   4,  4,  4,  4, 4, 4,  8, 4, // 0x50-0x5F
-	4,  4,  4, 4,  4,  4,  8,  4,   4,  4,  4,  4, 4, 4,  8, 4, // 0x60-0x6F
-	8,  8,  8, 8,  8,  8,  4,  8,   4,  4,  4,  4, 4, 4,  8, 4, // 0x70-0x7F
-	4,  4,  4, 4,  4,  4,  8,  4,   4,  4,  4,  4, 4, 4,  8, 4, // 0x80-0x8F
-	4,  4,  4, 4,  4,  4,  8,  4,   4,  4,  4,  4, 4, 4,  8, 4, // 0x90-0x9F
-	4,  4,  4, 4,  4,  4,  8,  4,   4,  4,  4,  4, 4, 4,  8, 4, // 0xA0-0xAF
-	4,  4,  4, 4,  4,  4,  8,  4,   4,  4,  4,  4, 4, 4,  8, 4, // 0xB0-0xBF
-	0,  12, 0, 16, 0,  16, 8,  16,  0,  16, 0,  0, 0, 24, 8, 16, // 0xC0-0xCF
-	0,  12, 0, 0,  0,  16, 8,  16,  0,  16, 0,  0, 0, 0,  8, 16, // 0xD0-0xDF
-	12, 12, 8, 0,  0,  16, 8,  16,  16, 4,  16, 0, 0, 0,  8, 16, // 0xE0-0xEF
-	12, 12, 8, 4,  0,  16, 8,  16,  12, 8,  16, 4, 0, 0,  8, 16  // 0xF0-0xFF
-};
-
-// taken from https://github.com/retrio/gb-test-roms/tree/master/instr_timing
-const Byte cbOpcodeTicks[256] = 
-{
-    8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0x0-0xF
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0x10-0x1F
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0x20-0x2F
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0x30-0x3F
-	8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8, // 0x40-0x4F
-	8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8, // 0x50-0x5F
-	8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8, // 0x60-0x6F
-	8, 8, 8, 8, 8, 8, 12, 8, 8, 8, 8, 8, 8, 8, 12, 8, // 0x70-0x7F
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0x80-0x8F
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0x90-0x9F
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0xA0-0xAF
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0xB0-0xBF
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0xC0-0xCF
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0xD0-0xDF
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8, // 0xE0-0xEF
-	8, 8, 8, 8, 8, 8, 16, 8, 8, 8, 8, 8, 8, 8, 16, 8  // 0xF0-0xFF
-};
-
-// timer offsets
-const DoubleByte DIV_REGISTER_OFFSET  = 0xFF04;
-const DoubleByte TIMA_REGISTER_OFFSET = 0xFF05;
-const DoubleByte TMA_REGISTER_OFFSET  = 0xFF06;
-const DoubleByte TAC_REGISTER_OFFSET  = 0xFF07;
+#include "OpcodeProfiler.h"
 
 // initialize values for the CPU
-CPU::CPU()
+CPU::CPU() : mScheduler(&mState.nextEventTicks), mInterruptHandler(&mState.interruptsEnabled), mBlockCache(&mState.codeVersion)
 {
     mmu = new MMU;
 
-    // set the ticks (as well as the ticks for the timers) to 0
-    mTicks         = 0;
-    mDivTimerTicks = 0;
-    mTimerTicks    = 0;
+    // set the ticks to 0
+    mState.ticks = 0;
+
+    mState.halted = false;
+
+    // the fetch page is looked up the first time an opcode is fetched (0x1 can never be the start of a page)
+    mState.fetchPage        = NULL;
+    mState.fetchPageAddr    = 0x1;
+    mState.fetchPageVersion = 0;
 
     // reset all the registers
-    mRegisters.reset();
+    mState.registers.reset();
+
+    // initialize the timer, before the MMU writes the starting values of its registers
+    mTimer.init(&mState.ticks, mmu, &mScheduler);
 
     // initialize the MMU
-    mmu->init(&mTicks, &mClockSpeed, &mClockEnabled);
+    mmu->init(&mState, &mBlockCache, &mScheduler, &mPPU, &mTimer);
 
     // initialize the PPU
     mPPU.init(mmu);
+
+#ifdef HERMES_JIT
+    mJIT.init(this);
+#endif
     
     // default values that the emulator assumes after the BIOS would have run
-    mRegisters.pc = 0x100;
-    mRegisters.A = 0x1;
-    mRegisters.F = 0xB0;
-    mRegisters.B = 0x0;
-    mRegisters.C = 0x13;
-    mRegisters.D = 0;
-    mRegisters.E = 0xD8;
-    mRegisters.H = 0x01;
-    mRegisters.L = 0x4D;
-    mRegisters.sp = 0xfffe;
+    mState.registers.pc = 0x100;
+    mState.registers.A = 0x1;
+    mState.registers.F = 0xB0;
+    mState.registers.B = 0x0;
+    mState.registers.C = 0x13;
+    mState.registers.D = 0;
+    mState.registers.E = 0xD8;
+    mState.registers.H = 0x01;
+    mState.registers.L = 0x4D;
+    mState.registers.sp = 0xfffe;
 }
 
 // emulates a single opcode from the cpu
 void CPU::emulateCycle()
 {
     // fetch an instruction
-    Byte opcode = mmu->readByte(mRegisters.pc);
+    Byte opcode = fetchByte(mState.registers.pc);
+
+#ifdef HERMES_MEMORY_HOOKS
+    if (mmu->getHooks().isWatched(HookType::EXECUTE, mState.registers.pc))
+        mmu->getHooks().run(HookType::EXECUTE, mState.registers.pc, opcode);
+#endif
     
     // increment the program counter to the next instruction
-    mRegisters.pc++;
+    mState.registers.pc++;
+
+    // look up everything needed to decode and execute the opcode in one go
+    const Opcode& instruction = OPCODES[opcode];
 
     // find the operand that is to be used in the opcode's instruction
-    DoubleByte operand;
+    DoubleByte operand = 0;
 
     // the following if statements ensure that we properly fetch the operand (without overflowing into the next Byte)
-    if (OPCODE_OPERAND_SIZE[opcode] == 1)
-        operand = mmu->readByte(mRegisters.pc);
-    else if (OPCODE_OPERAND_SIZE[opcode] == 2)
-        operand = mmu->readDoubleByte(mRegisters.pc);
+    if (instruction.operandSize == 1)
+        operand = fetchByte(mState.registers.pc);
+    else if (instruction.operandSize == 2)
+        operand = fetchDoubleByte(mState.registers.pc);
 
     // increase the program counter by the number of bytes that the operand took up
-    mRegisters.pc += OPCODE_OPERAND_SIZE[opcode];
+    mState.registers.pc += instruction.operandSize;
 
     // record the old number of ticks (used to accurately update the number of ticks that have passed to the PPU,
     // as sometimes the number of ticks that an instruction takes is dependent on various conditions)
-    uint64_t oldTicks = mTicks;
+    uint64_t oldTicks = mState.ticks;
 
-    // adds the number of ticks the opcode took
-    mTicks += opcodeTicks[opcode];
+    // adds the number of ticks the opcode took (the CB-prefixed opcodes add their own ticks when they are handled)
+    mState.ticks += instruction.ticks;
 
-    // if the opcode is going to go into the CB-prefixed opcode table, then add the number of ticks the CB-prefixed opcode will take
-    if (opcode == 0xCB)
-        mTicks += cbOpcodeTicks[(Byte)operand];
+    instruction.handler(*this, operand);
 
-    handleOpcodes(opcode, operand);
-                  
-    // tick as well the ppu (telling it how many cycles the CPU has just used)
-    mPPU.tick(mTicks - oldTicks);
+    updateComponents(opcode, mState.ticks - oldTicks);
+}
+
+// runs as many blocks as it takes to emulate the given number of ticks. anything that stays the same from one
+// block to the next is kept in locals, rather than looked up again for every block
+void CPU::runFor(int cycles)
+{
+    uint64_t targetTicks = mState.ticks + cycles;
+
+    // the selected ROM bank can only change when the block cache's version does (as writing to the memory bank
+    // controller counts as a bank switch), so it only has to be asked for again when that happens
+    uint32_t bankVersion = mBlockCache.getVersion();
+    DoubleByte romBank = mmu->memoryChip->getSelectedROMBank();
+
+    while (mState.ticks < targetTicks)
+    {
+        if (mBlockCache.getVersion() != bankVersion)
+        {
+            bankVersion = mBlockCache.getVersion();
+            romBank = mmu->memoryChip->getSelectedROMBank();
+        }
+
+        emulateBlock(romBank, targetTicks);
+    }
+}
+
+// emulates the block of opcodes starting at the program counter, decoding it first if it hasn't been ran before
+void CPU::emulateBlock(DoubleByte romBank, uint64_t maxTicks)
+{
+    if (mState.halted)
+    {
+        runHalted(maxTicks);
+        return;
+    }
+
+#ifdef HERMES_MEMORY_HOOKS
+    // code that an execute or read hook is watching is never cached, so that the hooks see every opcode that is fetched
+    if (mmu->getHooks().isCodeWatched(mState.registers.pc))
+    {
+        emulateCycle();
+        return;
+    }
+#endif
+
+    // code on a bus that an OAM DMA transfer is using can't be fetched (it reads as 0xFF), so it can't be ran from or put in the cache
+    if (mmu->isBlockedByDMA(mState.registers.pc))
+    {
+        emulateCycle();
+        return;
+    }
+
+    Block* block = mBlockCache.findBlock(mState.registers.pc, romBank);
+    if (block == NULL)
+        block = compileBlock(mState.registers.pc, romBank);
+
+    // code that can't be cached is just ran one opcode at a time
+    if (block == NULL)
+    {
+        emulateCycle();
+        return;
+    }
+
+    if (block->idleLoop)
+        runIdleLoop(block, maxTicks);
+    else
+        runBlock(block, maxTicks);
+}
+
+// runs the given block, starting at the program counter
+void CPU::runBlock(Block* block, uint64_t maxTicks)
+{
+#ifdef HERMES_JIT
+    // blocks of ROM code that are ran often enough get translated into native code (code in RAM can change, so it is always interpreted)
+    if (block->nativeCode == NULL && block->startAddr <= 0x7FFF && ++block->executions == JIT::HOT_BLOCK_THRESHOLD)
+        mJIT.compile(*block);
+
+    if (block->nativeCode != NULL)
+    {
+        // the native code keeps F in a host register, so it can't have any flags still pending
+        mState.registers.resolveFlags();
+        ((JIT::NativeBlock)block->nativeCode)(this, maxTicks, mBlockCache.getVersionAddress());
+        return;
+    }
+#endif
+
+    // if an opcode ends up throwing away the block (by writing over its code or switching the ROM bank), the block's
+    // memory could be gone, so the opcodes are read through a plain pointer and never touched again after that happens
+    uint32_t version = mBlockCache.getVersion();
+    const MicroOp* ops = block->ops.data();
+    size_t numOps = block->ops.size();
+
+    for (size_t index = 0; index < numOps; index++)
+    {
+        const MicroOp op = ops[index];
+
+        // a superinstruction runs the instructions after it itself, and checks whether the block can go on after each of them
+        if (op.fusedOps)
+        {
+            if (!op.superinstruction(*this, &ops[index + 1], maxTicks, version))
+                return;
+
+            index += op.fusedOps;
+            continue;
+        }
+
+        // the operand has already been fetched, so the program counter can skip straight past the whole instruction
+        mState.registers.pc += op.length;
+        DoubleByte nextPC = mState.registers.pc;
+
+        uint64_t oldTicks = mState.ticks;
+        mState.ticks += op.ticks;
+
+        op.handler(*this, op.operand);
+
+        // stop running the block if an interrupt moved the program counter somewhere else, if enough ticks went by or if the block is no longer valid
+        if (!finishInstruction(op.opcode, mState.ticks - oldTicks, nextPC, maxTicks, version))
+            return;
+    }
+}
+
+/*
+    a lot of games spend most of their time in a loop waiting for something to change, like the LY register reaching 144, or an interrupt
+    handler setting a flag in RAM. an idle loop only reads memory and compares what it read (so it writes nothing, and only changes A
+    and F), which means that if going around it once leaves A and F the same as they were, every time after that will do exactly the
+    same thing until the memory it reads changes. the CPU itself can't change that memory, so only the PPU or the timer can (input is
+    only checked in between calls to runFor). the loop is ran once to see if it settles like that, and then as many more times around it
+    as fit before the next PPU state change or timer overflow (or maxTicks) are skipped over at once
+*/
+void CPU::runIdleLoop(Block* block, uint64_t maxTicks)
+{
+    DoubleByte startAddr = block->startAddr;
+    uint64_t startTicks = mState.ticks;
+    uint64_t eventTicks = getTicksUntilNextEvent();
+
+    mState.registers.resolveFlags();
+    Byte a = mState.registers.A;
+    Byte f = mState.registers.F;
+
+    runBlock(block, maxTicks);
+
+    // it only settled if it went all the way around the loop without the PPU or timer changing anything, and without changing A or F
+    uint64_t loopTicks = mState.ticks - startTicks;
+    if (mState.registers.pc != startAddr || loopTicks >= eventTicks || mState.ticks >= maxTicks)
+        return;
+
+    mState.registers.resolveFlags();
+    if (mState.registers.A != a || mState.registers.F != f)
+        return;
+
+    // skip every time around the loop that would finish before the next event, as well as before maxTicks (as running the loop normally
+    // would have stopped at the first instruction that reached it)
+    uint64_t ticksLeft = std::min(eventTicks - loopTicks, maxTicks - mState.ticks) - 1;
+    uint64_t loops = ticksLeft / loopTicks;
+
+    if (loops > 0)
+        skipTicks(loops * loopTicks);
+}
+
+// while the CPU is halted, it runs the HALT opcode over and over again (taking 4 ticks every time) until an interrupt is requested.
+// only the PPU and the timer can request one (input is only checked in between calls to runFor), so all of the HALTs before the
+// next event (or maxTicks) can be skipped over at once. the HALT where something might happen is then ran normally
+void CPU::runHalted(uint64_t maxTicks)
+{
+    const int HALT_TICKS = 4;
+
+    // an interrupt could already have been requested by the time the last HALT finished, in which case it has to run again to wake up
+    if (!mState.pendingInterrupts)
+    {
+        uint64_t ticksLeft = std::min(getTicksUntilNextEvent(), maxTicks - mState.ticks) - 1;
+        uint64_t halts = ticksLeft / HALT_TICKS;
 
-    // update the clocks before the interrupts, because it is possible that a timer interrupt has occured after the previous opcode
-    updateClocks(mTicks - oldTicks);
+        if (halts > 0)
+            skipTicks(halts * HALT_TICKS);
+    }
+
+    emulateCycle();
+}
+
+uint64_t CPU::getTicksUntilNextEvent()
+{
+    // the div register and the timer going up (without overflowing) aren't events, so every event that is scheduled matters here
+    uint64_t eventTicks = mScheduler.getNextEventTicks();
+
+    return eventTicks > mState.ticks ? eventTicks - mState.ticks : 0;
+}
+
+// does the same thing as running the instructions that took up the given ticks, as long as they change nothing themselves and the
+// PPU doesn't change state and the timer doesn't overflow in that time (which means no interrupts can happen either)
+void CPU::skipTicks(uint64_t ticks)
+{
+    mState.ticks += ticks;
 
-    mInterruptHandler.checkInterupts(opcode, &mRegisters, mmu);
+    // the div register and the timer are worked out from the tick count, so they don't need to be told about this
+    if (mState.ticks >= mState.nextEventTicks)
+        runEvents(0, 0);
 }
 
-void CPU::updateClocks(int deltaTicks)
+// returns true if the given opcode can change the program counter, which means that the block has to end with it
+static bool endsBlock(Byte opcode)
 {
-    // the div register timer increments at 16384Hz (which is achieved with 1 increment every 256 ticksd)
-    mDivTimerTicks += deltaTicks;
-    if (mDivTimerTicks >= 256)
+    switch (opcode)
     {
-        mDivTimerTicks -= 256;
+        case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:             // JR
+        case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: case 0xE9: // JP
+        case 0xC4: case 0xCC: case 0xCD: case 0xD4: case 0xDC:             // CALL
+        case 0xC0: case 0xC8: case 0xC9: case 0xD0: case 0xD8: case 0xD9: // RET and RETI
+        case 0xC7: case 0xCF: case 0xD7: case 0xDF:                        // RST
+        case 0xE7: case 0xEF: case 0xF7: case 0xFF:
+        case 0x76:                                                         // HALT (which moves the program counter back onto itself)
+            return true;
+        default:
+            return false;
+    }
+}
 
-        // the memory has to be manually updated like this (i.e., without using mmu->writeByte) because if the gameboy game attempts
-        // to update the div register with any value, it will always be reset to 0, but we need to be incrementing it
-        mmu->ramMemory[DIV_REGISTER_OFFSET - RAM_OFFSET]++;
+// returns true if the instruction only reads memory or compares A (changing nothing but A and F), which is all an idle loop can do
+static bool isIdleOp(const MicroOp& op)
+{
+    switch (op.opcode)
+    {
+        case 0x00: // NOP
+        case 0xA7: // AND_A_A
+        case 0xB7: // OR_A_A
+        case 0xE6: // AND_N
+        case 0xF6: // OR_N
+        case 0xFE: // CP_N
+            return true;
+
+        // LDH_A_N: the div and TIMA registers change on their own, so a loop reading them is never idle
+        case 0xF0:
+            return op.operand != 0x04 && op.operand != 0x05;
+
+        // LD_A_NN: the same goes for the div and TIMA registers, and cartridge RAM can be a clock that changes on its own as well
+        case 0xFA:
+            return op.operand != 0xFF04 && op.operand != 0xFF05 && (op.operand < 0xA000 || op.operand > 0xBFFF);
+
+        // BIT_B_R: testing a bit of any register besides (HL)
+        case 0xCB:
+            return (op.operand & 0xC0) == 0x40 && (op.operand & 7) != 6;
+
+        default:
+            return false;
     }
+}
 
-    // if the timer is actually enabled, then update the TIMA register
-    if (mClockEnabled)
+// returns true if the block only reads and compares memory before jumping back to its start (see runIdleLoop)
+static bool isIdleLoop(const Block& block)
+{
+    const MicroOp& jump = block.ops.back();
+    DoubleByte target;
+
+    switch (jump.opcode)
     {
-        mTimerTicks += deltaTicks;
+        case 0x18: case 0x20: case 0x28: case 0x30: case 0x38: // JR
+            target = block.endAddr + (Signedbyte)jump.operand;
+            break;
+        case 0xC2: case 0xC3: case 0xCA: case 0xD2: case 0xDA: // JP
+            target = jump.operand;
+            break;
+        default:
+            return false;
+    }
+
+    if (target != block.startAddr)
+        return false;
 
-        // if enough ticks have gone by that we should increment the tick timer (according to the current clock speed,
-        // which can be updated by writing to the timer control register)
-        while (mTimerTicks >= mClockSpeed)
+    for (size_t index = 0; index < block.ops.size() - 1; index++)
+        if (!isIdleOp(block.ops[index]))
+            return false;
+
+    return true;
+}
+
+// fetches and decodes opcodes starting at addr until an opcode that can change the program counter is found
+Block* CPU::compileBlock(DoubleByte addr, DoubleByte romBank)
+{
+    Block block;
+    block.startAddr = addr;
+
+    DoubleByte pc = addr;
+    while (block.ops.size() < BlockCache::MAX_BLOCK_LENGTH)
+    {
+        Byte opcode = fetchByte(pc);
+        const Opcode& instruction = OPCODES[opcode];
+
+        MicroOp op;
+        op.handler = instruction.handler;
+        op.operand = 0;
+        op.ticks   = instruction.ticks;
+        op.length  = instruction.operandSize + 1;
+        op.opcode  = opcode;
+        op.fusedOps = 0;
+
+        // the whole instruction (including its operand) has to be in the same region of memory as the start of the block
+        if (!BlockCache::isCacheable(addr, pc + op.length - 1))
+            break;
+
+#ifdef HERMES_MEMORY_HOOKS
+        if (mmu->getHooks().isCodeWatched(pc) || mmu->getHooks().isCodeWatched(pc + op.length - 1))
+            break;
+#endif
+
+        if (instruction.operandSize == 1)
+            op.operand = fetchByte(pc + 1);
+        else if (instruction.operandSize == 2)
+            op.operand = fetchDoubleByte(pc + 1);
+
+        // CB-prefixed opcodes can be looked up right away, instead of going through the 0xCB handler every time
+        if (opcode == 0xCB)
         {
-            // read in the TIMA register and increment it
-            Byte timerCounter = mmu->readByte(TIMA_REGISTER_OFFSET) + 1;
-            mmu->writeByte(TIMA_REGISTER_OFFSET, timerCounter);
-
-            // if the timer overflowed, then cause an interrupt and 
-            // reset the timer counter to the value specified in the TMA register
-            if (timerCounter == 0)
-            {
-                mmu->writeByte(TIMA_REGISTER_OFFSET, mmu->readByte(TMA_REGISTER_OFFSET));
-                mmu->writeByte(INTERRUPT_OFFSET, mmu->readByte(INTERRUPT_OFFSET) | (Byte)Interrupts::TIMER);
-            }
-
-            // in case there was overflow (i.e., the cpu clock speed is 1 increment per 1024, but 1030 ticks went by, then we would set the current timer ticks to 4)
-            mTimerTicks -= mClockSpeed;
+            const Opcode& cbInstruction = CB_OPCODES[(Byte)op.operand];
+            op.handler = cbInstruction.handler;
+            op.ticks   = cbInstruction.ticks;
         }
+
+        block.ops.push_back(op);
+        pc += op.length;
+
+        if (endsBlock(opcode))
+            break;
+    }
+
+    if (block.ops.empty())
+        return NULL;
+
+    block.endAddr = pc;
+    block.idleLoop = isIdleLoop(block);
+
+#ifdef HERMES_SUPERINSTRUCTIONS
+    fuseSuperinstructions(block);
+#endif
+
+    return mBlockCache.insertBlock(block, romBank);
+}
+
+// once an instruction has been executed, the rest of the gameboy has to catch up with anything that was due to happen by now
+void CPU::runEvents(Byte opcode, int deltaTicks)
+{
+    // tick as well the ppu (telling it how many cycles the CPU has just used)
+    if (mScheduler.isDue(Event::PPU, mState.ticks))
+    {
+        mPPU.update(mState.ticks, deltaTicks);
+        mScheduler.schedule(Event::PPU, mPPU.getNextStateTicks());
+    }
+
+    // update the timer before the interrupts, because it is possible that a timer interrupt has occured after the previous opcode
+    if (mScheduler.isDue(Event::TIMER, mState.ticks))
+        mTimer.update();
+
+    if (mScheduler.isDue(Event::DMA, mState.ticks))
+        mmu->finishDMA();
+
+    // requesting an interrupt (which the PPU and timer do by writing to the IF register) schedules this, so it always comes last
+    if (mScheduler.isDue(Event::INTERRUPTS, mState.ticks))
+    {
+        // servicing an interrupt wakes the CPU up if it was halted
+        if (mInterruptHandler.checkInterupts(opcode, &mState.registers, mmu))
+            mState.halted = false;
+
+        // nothing else can be serviced until another interrupt becomes pending or interrupts are enabled again (servicing an
+        // interrupt disables them, so its own write to the IF register doesn't matter)
+        mScheduler.cancel(Event::INTERRUPTS);
     }
 }
 
 // encode all of the current register values into a save file from addresses 0-0xB
 void CPU::saveRegistersToFile(std::ofstream& file)
 {
+    // make sure F is up to date before it is saved
+    mState.registers.resolveFlags();
+
     // store all the value registers into the first 8 bytes
-    file.write((char*)&mRegisters.A, 1);
-    file.write((char*)&mRegisters.B, 1);
-    file.write((char*)&mRegisters.C, 1);
-    file.write((char*)&mRegisters.D, 1);
-    file.write((char*)&mRegisters.E, 1);
-    file.write((char*)&mRegisters.F, 1);
-    file.write((char*)&mRegisters.H, 1);
-    file.write((char*)&mRegisters.L, 1);
+    file.write((char*)&mState.registers.A, 1);
+    file.write((char*)&mState.registers.B, 1);
+    file.write((char*)&mState.registers.C, 1);
+    file.write((char*)&mState.registers.D, 1);
+    file.write((char*)&mState.registers.E, 1);
+    file.write((char*)&mState.registers.F, 1);
+    file.write((char*)&mState.registers.H, 1);
+    file.write((char*)&mState.registers.L, 1);
 
     // store the stack pointer and the pc
-    file.write((char*)&mRegisters.sp, 2);
-    file.write((char*)&mRegisters.pc, 2);
+    file.write((char*)&mState.registers.sp, 2);
+    file.write((char*)&mState.registers.pc, 2);
 }
 
 void CPU::saveInterruptDataToFile(std::ofstream& file)
@@ -226,118 +489,82 @@ void CPU::setRegistersFromFile(std::ifstream& file)
 
     // store the first 12 bytes of the file into dataBuffer
     file.read(dataBuffer, 12);
+
+    // get rid of any pending flags so that they don't overwrite the loaded F
+    mState.registers.resolveFlags();
+
+    // whether the CPU was halted isn't saved. if it was, it will just run the HALT it was on again, which halts it again
+    mState.halted = false;
     
-    mRegisters.A = dataBuffer[0];
-    mRegisters.B = dataBuffer[1];
-    mRegisters.C = dataBuffer[2];
-    mRegisters.D = dataBuffer[3];
-    mRegisters.E = dataBuffer[4];
-    mRegisters.F = dataBuffer[5];
-    mRegisters.H = dataBuffer[6];
-    mRegisters.L = dataBuffer[7];
+    mState.registers.A = dataBuffer[0];
+    mState.registers.B = dataBuffer[1];
+    mState.registers.C = dataBuffer[2];
+    mState.registers.D = dataBuffer[3];
+    mState.registers.E = dataBuffer[4];
+    mState.registers.F = dataBuffer[5];
+    mState.registers.H = dataBuffer[6];
+    mState.registers.L = dataBuffer[7];
 
     // taking into account the little endianess (hence all the bit shifting)
-    mRegisters.sp = (DoubleByte(Byte(dataBuffer[9])) << 8)  | Byte(dataBuffer[8]);
-    mRegisters.pc = (DoubleByte(Byte(dataBuffer[11])) << 8) | Byte(dataBuffer[10]);
+    mState.registers.sp = (DoubleByte(Byte(dataBuffer[9])) << 8)  | Byte(dataBuffer[8]);
+    mState.registers.pc = (DoubleByte(Byte(dataBuffer[11])) << 8) | Byte(dataBuffer[10]);
 }
 
 // general function for rotating a byte left (usually an 8-bit register), checking to see if the carry flag should be set, and clearing all other flags
 Byte CPU::rlc(Byte val)
 {
-    // if the leftmost bit is set, then shifting once to the left will cause an overflow (which will set the carry flag)
-    if (val & 0x80)
-    {
-        // shift the value once to the left and then wrap the bit around to the front
-        val <<= 1;
-        val += 1;
-        mRegisters.setFlag(CARRY_FLAG);
-    }
-    else
-    {
-        val <<= 1;
-        mRegisters.maskFlag(CARRY_FLAG);
-    }
-
-    if (val == 0) mRegisters.setFlag(ZERO_FLAG);
-    else          mRegisters.maskFlag(ZERO_FLAG);
-
     // clear all the other flags
-    mRegisters.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+    mState.registers.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
 
-    return val;
+    // shift the value once to the left and then wrap the leftmost bit around to the front. the leftmost bit also
+    // ends up in the 9th bit of the result, which is what the carry flag is worked out from
+    DoubleByte result = (val << 1) | (val >> 7);
+    mState.registers.setLazyFlags(ZERO_FLAG | CARRY_FLAG, result, 0);
+
+    return result & 0xFF;
 }
 
 // general function for rotating a byte left and setting the rightmost bit if the carry flag was already set. it also checks to see if the carry flag should be set
 Byte CPU::rl(Byte val)
 {
     // set the following variable to 1 if the carry flag is set, and 0 otherwise
-    Byte carry = mRegisters.isFlagSet(CARRY_FLAG);
-
-    // if the leftmost bit of val is set
-    if (val & 0x80)
-        mRegisters.setFlag(CARRY_FLAG);
-    else
-        mRegisters.maskFlag(CARRY_FLAG);
-
-    // left shift val and apply the carry
-    val <<= 1;
-    val += carry;
-
-    if (val == 0) mRegisters.setFlag(ZERO_FLAG);
-    else          mRegisters.maskFlag(ZERO_FLAG);
+    Byte carry = mState.registers.isFlagSet(CARRY_FLAG);
 
     // clear all the other flags
-    mRegisters.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+    mState.registers.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
 
-    return val;
+    // left shift val and apply the carry. the leftmost bit of val ends up in the 9th bit of the result, which becomes the new carry flag
+    DoubleByte result = (val << 1) | carry;
+    mState.registers.setLazyFlags(ZERO_FLAG | CARRY_FLAG, result, 0);
+
+    return result & 0xFF;
 }
 
 // general function for rotating a byte right and checking flags
 Byte CPU::rrc(Byte val)
 {
-    // if the right most bit is set, wrap said bit to the left side of val
-    if (val & 0x1)
-    {
-        val >>= 1;
-        val |= (1) << 7;
-        mRegisters.setFlag(CARRY_FLAG);
-    }
-    else
-    {
-        val >>= 1;
-        mRegisters.maskFlag(CARRY_FLAG);
-    }
-
-    if (val == 0) mRegisters.setFlag(ZERO_FLAG);
-    else          mRegisters.maskFlag(ZERO_FLAG);
-
     // clear all the other flags
-    mRegisters.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+    mState.registers.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
 
-    return val;
+    // wrap the right most bit around to the left side of val, and put it in the 9th bit of the result as well for the carry flag
+    DoubleByte result = (val >> 1) | ((val & 0x1) << 7) | ((val & 0x1) << 8);
+    mState.registers.setLazyFlags(ZERO_FLAG | CARRY_FLAG, result, 0);
+
+    return result & 0xFF;
 }
 
 // general function for rotating a byte right and setting the leftmost bit if the carry flag was already set. it also checks to see if the carry flag should be set
 Byte CPU::rr(Byte val)
 {
     // set the following variable to 1 if the carry flag is set, and 0 otherwise
-    Byte carry = mRegisters.isFlagSet(CARRY_FLAG);
-
-    // if the leftmost bit of val is set
-    if (val & 0x1)
-        mRegisters.setFlag(CARRY_FLAG);
-    else
-        mRegisters.maskFlag(CARRY_FLAG);
-
-    // left shift val and apply the carry
-    val >>= 1;
-    val |= carry << 7;
-
-    if (val == 0) mRegisters.setFlag(ZERO_FLAG);
-    else          mRegisters.maskFlag(ZERO_FLAG);
+    Byte carry = mState.registers.isFlagSet(CARRY_FLAG);
 
     // clear all the other flags
-    mRegisters.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+    mState.registers.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+
+    // right shift val and apply the carry to the leftmost bit. the rightmost bit of val becomes the new carry flag
+    DoubleByte result = (val >> 1) | (carry << 7) | ((val & 0x1) << 8);
+    mState.registers.setLazyFlags(ZERO_FLAG | CARRY_FLAG, result, 0);
 
-    return val;
+    return result & 0xFF;
 }
\ No newline at end of file
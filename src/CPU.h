@@ -1,26 +1,36 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <fstream>
+#include <utility>
 
+#include "BlockCache.h"
 #include "Cartridge.h"
 #include "Constants.h"
+#include "CoreState.h"
 #include "InterruptHandler.h"
+#include "JIT.h"
 #include "MMU.h"
+#include "OpcodeProfiler.h"
 #include "PPU.h"
 #include "Registers.h"
+#include "Scheduler.h"
+#include "Timer.h"
 
 // the CPU class fetches opcodes and interprets them
 class CPU
 {
 private:
-    Registers mRegisters;
-    uint64_t mTicks;
+    // the registers, ticks, etc. that are used by (almost) every instruction. this comes first, as the scheduler, interrupt handler
+    // and block cache are constructed with pointers into it
+    CoreState mState;
 
-    uint32_t mTimerTicks;
-    uint16_t mDivTimerTicks;
-    DoubleByte mClockSpeed;
-    bool mClockEnabled;
+    // the PPU, timers and interrupts only get updated when the scheduler says they need to be
+    Scheduler mScheduler;
+
+    // handles the DIV and TIMA registers
+    Timer mTimer;
     
     // handles VBLANK interupts, and in the future LCD interupts and i/o interupts
     InterruptHandler mInterruptHandler;
@@ -66,15 +76,127 @@ private:
 
     void testBit(Byte val, Byte bit); // tests the given bit of the given val
 
-    // handles all non-prefixed opcodes
-    void handleOpcodes(Byte opcode, DoubleByte operand);
+    // everything the CPU needs to know to fetch and execute a single opcode
+    struct Opcode
+    {
+        Byte operandSize;      // how big (in bytes) the operand that follows the opcode is
+        Byte ticks;            // the number of ticks the opcode takes. 0 means the handler adds them, as they depend on a condition
+        OpcodeHandler handler; // the function that executes the opcode
+    };
+
+    // handles all non-prefixed opcodes (defined in opcodes.cpp)
+    static const Opcode OPCODES[256];
 
-    // this handles the 256 case switch statement for CB-prefixed opcodes
+    // handles all CB-prefixed opcodes (defined in cbOpcodes.cpp)
     // sometimes, the gameboy's instructions will have the opcode of CB, and the 1 byte operand the follows
     // will tell you which extended opcode it would like to execute
-    void handleCBOpcodes(Byte opcode);
+    static const std::array<Opcode, 256> CB_OPCODES;
+
+    // the opcodes from 0x40-0xBF, as well as all of the CB-prefixed opcodes, follow a regular pattern where the lower 3 bits
+    // select a register (B, C, D, E, H, L, the value HL points to, or A), and the bits above them select the operation or bit.
+    // their handlers are generated from these templates, so each one is its own specialized function
+
+    // reads or writes the register selected by index
+    template<Byte index> Byte readRegister();
+    template<Byte index> void writeRegister(Byte val);
+
+    template<Byte opcode> static void loadRegister(CPU& cpu, DoubleByte operand); // opcodes 0x40-0x7F (besides HALT)
+    template<Byte opcode> static void aluRegister(CPU& cpu, DoubleByte operand);  // opcodes 0x80-0xBF
+    template<Byte opcode> static void cbOpcode(CPU& cpu, DoubleByte operand);     // every CB-prefixed opcode
+
+    template<size_t... opcodes>
+    static constexpr std::array<Opcode, 256> makeCBTable(std::index_sequence<opcodes...>);
+
+    // superinstructions for the most common sequences of opcodes (defined in superinstructions.cpp)
+    template<Byte jumpOpcode> static bool pollLoop(CPU& cpu, const MicroOp* ops, uint64_t maxTicks, uint32_t version);
+    template<Byte decOpcode> static bool decrementLoop(CPU& cpu, const MicroOp* ops, uint64_t maxTicks, uint32_t version);
+    static bool copyLoop(CPU& cpu, const MicroOp* ops, uint64_t maxTicks, uint32_t version);
+
+    // a sequence of opcodes that can be ran as a superinstruction
+    struct Superinstruction
+    {
+        Byte length;      // how many instructions are in the sequence
+        Byte opcodes[3];
+        SuperinstructionHandler handler;
+    };
+
+    static const Superinstruction SUPERINSTRUCTIONS[8];
+
+    // fetches a byte of code, using the fetch page where possible. the fetch page is a pointer straight to the 256 byte page of memory
+    // that the program counter is in, so that opcodes and operands can be fetched without going through the MMU. it is looked up again
+    // when fetching from another page, or after a bank switch (which changes the block cache's version). if it is NULL, the page has to
+    // be read through the MMU
+    Byte fetchByte(DoubleByte addr)
+    {
+        if ((addr & 0xFF00) != mState.fetchPageAddr || mState.fetchPageVersion != mState.codeVersion)
+        {
+            mState.fetchPageAddr    = addr & 0xFF00;
+            mState.fetchPageVersion = mState.codeVersion;
+            mState.fetchPage        = mmu->getReadPointer(mState.fetchPageAddr);
+        }
+
+        if (mState.fetchPage == NULL)
+            return mmu->readByte(addr);
+
+        return mState.fetchPage[addr & 0xFF];
+    }
+
+    DoubleByte fetchDoubleByte(DoubleByte addr) { return (DoubleByte(fetchByte(addr + 1)) << 8) | fetchByte(addr); }
+
+    // holds blocks of instructions that have already been decoded, so that they can be ran without fetching them again
+    BlockCache mBlockCache;
+
+#ifdef HERMES_JIT
+    // translates hot blocks into native code. it needs to reach into the registers and ticks directly
+    JIT mJIT;
+    friend class JIT;
+#endif
+
+    // decodes the instructions starting at addr into a new block and caches it (returns NULL if the code at addr can't be cached)
+    Block* compileBlock(DoubleByte addr, DoubleByte romBank);
+
+    // puts superinstructions in front of the sequences in a freshly decoded block that have them
+    void fuseSuperinstructions(Block& block);
+
+    // emulates a whole block of opcodes at once, stopping early if the ticks reach maxTicks
+    void emulateBlock(DoubleByte romBank, uint64_t maxTicks);
+    void runBlock(Block* block, uint64_t maxTicks);
+
+    // runs an idle loop once, and then skips over as many more times around it as it can without changing the outcome
+    void runIdleLoop(Block* block, uint64_t maxTicks);
+
+    // returns how many ticks it will be until the PPU or the timer changes anything an idle loop could be waiting on
+    uint64_t getTicksUntilNextEvent();
+
+    // skips ahead to the next time that an interrupt could be requested while the CPU is halted
+    void runHalted(uint64_t maxTicks);
+
+    // lets the given number of ticks go by all at once. nothing but the div register and the timer may change in that time
+    // (meaning it can't reach the PPU's next state or a timer overflow)
+    void skipTicks(uint64_t ticks);
+
+    // lets the rest of the gameboy catch up after an instruction has been executed. most of the time nothing is due yet
+    void updateComponents(Byte opcode, int deltaTicks)
+    {
+        if (mState.ticks >= mState.nextEventTicks)
+            runEvents(opcode, deltaTicks);
+
+#ifdef HERMES_PROFILE_OPCODES
+        OpcodeProfiler::record(opcode);
+#endif
+    }
+
+    // handles every event that is due, after an instruction that took deltaTicks
+    void runEvents(Byte opcode, int deltaTicks);
+
+    // lets the rest of the gameboy catch up after an instruction in a block, then returns false if the block has to stop running
+    // (because an interrupt moved the program counter away from nextPC, enough ticks went by or the block is no longer valid)
+    bool finishInstruction(Byte opcode, int deltaTicks, DoubleByte nextPC, uint64_t maxTicks, uint32_t version)
+    {
+        updateComponents(opcode, deltaTicks);
+        return mState.registers.pc == nextPC && mState.ticks < maxTicks && mState.codeVersion == version;
+    }
 
-    void updateClocks(int deltaTicks);
 
 public:
     CPU();
@@ -83,13 +205,51 @@ public:
 
     void emulateCycle();
 
+    // emulates opcodes until at least the given number of ticks have gone by (stopping at the first opcode that reaches it)
+    void runFor(int cycles);
+
     // functions for loading/saving files
     void saveInterruptDataToFile(std::ofstream& file);
     void saveRegistersToFile(std::ofstream& file);
     void setRegistersFromFile(std::ifstream& file);
 
-    void enableInterrupts()  { mInterruptHandler.enableInterrupts(); }
+    // enabling interrupts means that one which was already pending has to be serviced
+    void enableInterrupts()
+    {
+        mInterruptHandler.enableInterrupts();
+
+        if (mState.pendingInterrupts)
+            mScheduler.schedule(Event::INTERRUPTS, mState.ticks);
+    }
+
     void disableInterrupts() { mInterruptHandler.disableInterrupts(); }
 
-    uint64_t getTicks() { return mTicks; }
-};
\ No newline at end of file
+    uint64_t getTicks() { return mState.ticks; }
+    bool isHalted() { return mState.halted; }
+};
+
+template<Byte index>
+inline Byte CPU::readRegister()
+{
+    if constexpr (index == 0)      return mState.registers.B;
+    else if constexpr (index == 1) return mState.registers.C;
+    else if constexpr (index == 2) return mState.registers.D;
+    else if constexpr (index == 3) return mState.registers.E;
+    else if constexpr (index == 4) return mState.registers.H;
+    else if constexpr (index == 5) return mState.registers.L;
+    else if constexpr (index == 6) return mmu->readByte(mState.registers.HL);
+    else                           return mState.registers.A;
+}
+
+template<Byte index>
+inline void CPU::writeRegister(Byte val)
+{
+    if constexpr (index == 0)      mState.registers.B = val;
+    else if constexpr (index == 1) mState.registers.C = val;
+    else if constexpr (index == 2) mState.registers.D = val;
+    else if constexpr (index == 3) mState.registers.E = val;
+    else if constexpr (index == 4) mState.registers.H = val;
+    else if constexpr (index == 5) mState.registers.L = val;
+    else if constexpr (index == 6) mmu->writeByte(mState.registers.HL, val);
+    else                           mState.registers.A = val;
+}
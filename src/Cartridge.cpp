@@ -2,6 +2,7 @@
 #include <stdlib.h>
 
 #include "Cartridge.h"
+#include "ROMCache.h"
 
 // include all the different memory chips that we might use
 #include "MemoryChips/ROMOnly.h"
@@ -22,41 +23,29 @@ const DoubleByte HEADER_END            = 0x014F;
 // load's a ROM into memory
 void Cartridge::loadROM(const char* romDir, MMU* mmu)
 {
-    // open the file provided by the directory as binary
-    FILE* romFile = fopen(romDir, "rb");
-    if (romFile == NULL)
-    {
-        printf("ROM file failed to load! Was the directory provided incorrect?");
-        exit(-1);
-    }
-
-    // find the length of the ROM file
-    fseek(romFile, 0L, SEEK_END); // seek to the end of the file
-    mROMSize = ftell(romFile);    // get the position of the cursor (now at the end of the file)
-    rewind(romFile);              // seek back to the beginning of the file
+    // the ROM (and its header) are shared with anything else in the process that has loaded the same file
+    mROM = ROMCache::load(romDir);
+    mROMSize = mROM->size;
 
-    mmu->romMemory = new Byte[mROMSize];
+    mmu->romMemory = mROM->memory;
 
-    // load the ROM file into memory
-    fread(mmu->romMemory, mROMSize, 1, romFile); // fills the ROM's memory with the data provided by the ROM file
-
-    switch (getType(mmu->romMemory))
+    switch (mROM->type)
     {
         case CartridgeType::ROM_ONLY: 
         case CartridgeType::ROM_AND_RAM:
         case CartridgeType::ROM_AND_RAM_AND_BATTERY:
-            mmu->memoryChip = new ROMOnly(mmu->romMemory, getNumRamBanks(mmu->romMemory));
+            mmu->memoryChip = new ROMOnly(mmu->romMemory, mROM->numRamBanks);
             break;
 
         case CartridgeType::MBC1:
         case CartridgeType::MBC1_AND_RAM:
         case CartridgeType::MBC1_AND_RAM_AND_BATTERY:
-            mmu->memoryChip = new MBC1(mmu->romMemory, getNumRomBanks(mmu->romMemory), getNumRamBanks(mmu->romMemory));
+            mmu->memoryChip = new MBC1(mmu->romMemory, mROM->numRomBanks, mROM->numRamBanks);
             break;
 
         case CartridgeType::MBC2:
         case CartridgeType::MBC2_AND_BATTERY:
-            mmu->memoryChip = new MBC2(mmu->romMemory, getNumRomBanks(mmu->romMemory), getNumRamBanks(mmu->romMemory));
+            mmu->memoryChip = new MBC2(mmu->romMemory, mROM->numRomBanks, mROM->numRamBanks);
             break;
 
         case CartridgeType::MBC3:
@@ -64,7 +53,7 @@ void Cartridge::loadROM(const char* romDir, MMU* mmu)
         case CartridgeType::MBC3_AND_TIMER_AND_BATTERY:
         case CartridgeType::MBC3_AND_TIMER_AND_RAM_AND_BATTERY:
         case CartridgeType::MBC3_AND_RAM_AND_BATTERY:
-            mmu->memoryChip = new MBC3(mmu->romMemory, getNumRomBanks(mmu->romMemory), getNumRamBanks(mmu->romMemory));
+            mmu->memoryChip = new MBC3(mmu->romMemory, mROM->numRomBanks, mROM->numRamBanks);
             break;
 
         case CartridgeType::MBC5:
@@ -73,21 +62,23 @@ void Cartridge::loadROM(const char* romDir, MMU* mmu)
         case CartridgeType::MBC5_AND_RUMBLE:
         case CartridgeType::MBC5_AND_RUMBLE_AND_RAM:
         case CartridgeType::MBC5_AND_RUMBLE_AND_RAM_AND_BATTERY:
-            mmu->memoryChip = new MBC5(mmu->romMemory, getNumRomBanks(mmu->romMemory), getNumRamBanks(mmu->romMemory));
+            mmu->memoryChip = new MBC5(mmu->romMemory, mROM->numRomBanks, mROM->numRamBanks);
             break;
 
         default:
             printf("That memory bank/cartridge type is not supported!\n");
             exit(0);
     }
+
+    mmu->mapROM();
 }
 
-CartridgeType Cartridge::getType(Byte* memory)
+CartridgeType Cartridge::getType(const Byte* memory)
 {
     return (CartridgeType)memory[HEADER_CARTRIDGE_TYPE];
 }
 
-int Cartridge::getNumRomBanks(Byte* memory)
+int Cartridge::getNumRomBanks(const Byte* memory)
 {
     switch (memory[HEADER_ROM_SIZE])
     {
@@ -104,7 +95,7 @@ int Cartridge::getNumRomBanks(Byte* memory)
     }
 }
 
-int Cartridge::getNumRamBanks(Byte* memory)
+int Cartridge::getNumRamBanks(const Byte* memory)
 {
     switch (memory[HEADER_ROM_SIZE])
     {
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <memory>
+
 #include "Constants.h"
 #include "MMU.h"
 
@@ -31,6 +33,8 @@ enum class CartridgeType
     MBC7_AND_SENSOR_AND_RUMBLE_AND_RAM_AND_BATTERY = 0x22,
 };
 
+struct ROMImage;
+
 class Cartridge
 {
 private:    
@@ -42,12 +46,15 @@ private:
 
     void extractHeaderData();
 
+    // the ROM, which is kept alive for as long as the cartridge is
+    std::shared_ptr<const ROMImage> mROM;
+
 public:
     Cartridge() {}
 
     void loadROM(const char* romDir, MMU* mmu);
 
-    CartridgeType getType(Byte* romMemory); // returns the cartridge type (most importantly the type of memory bank controller)
-    int getNumRomBanks(Byte* romMemory);
-    int getNumRamBanks(Byte* romMemory);
+    static CartridgeType getType(const Byte* romMemory); // returns the cartridge type (most importantly the type of memory bank controller)
+    static int getNumRomBanks(const Byte* romMemory);
+    static int getNumRamBanks(const Byte* romMemory);
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Constants.h"
+#include "Registers.h"
+
+/*
+    the state that (almost) every instruction touches, packed into a single 64 byte cache line. the CPU owns it, and the components
+    that used to keep some of it themselves (the scheduler, the block cache, the interrupt handler and the MMU) are given pointers into
+    it instead. everything else (the block cache's blocks, the scheduler's events, the MMU's memory, etc.) is only touched once in a
+    while, so it is kept out of the way
+*/
+struct alignas(64) CoreState
+{
+    Registers registers;
+
+    uint64_t ticks;
+
+    // the tick that the scheduler's earliest event is due at, which is compared against ticks after every instruction
+    uint64_t nextEventTicks;
+
+    // the page of memory that opcodes are being fetched from (see CPU::fetchByte), along with its address and the block cache
+    // version it was looked up with
+    const Byte* fetchPage;
+    uint32_t fetchPageVersion;
+
+    // the block cache's version, which is checked after every instruction in a block
+    uint32_t codeVersion;
+
+    DoubleByte fetchPageAddr;
+
+    // the interrupts that are both requested and enabled (IE & IF), kept up to date by the MMU
+    Byte pendingInterrupts;
+
+    // the interrupt master enable flag (IME), set and reset by the interrupt handler
+    bool interruptsEnabled;
+
+    // true while the CPU is sitting on a HALT opcode, waiting for an interrupt to be requested
+    bool halted;
+};
+
+static_assert(sizeof(CoreState) == 64, "the core state has to fit in a single cache line");
@@ -1,3 +1,5 @@
+#pragma once
+
 #include "Constants.h"
 #include "MMU.h"
 
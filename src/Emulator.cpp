@@ -4,6 +4,7 @@
 #include <thread>
 
 #include "Emulator.h"
+#include "OpcodeProfiler.h"
 
 // mapping for the save file encoding
 const DoubleByte SAVE_FILE_INTERRUPT_OFFSET = 0xC;
@@ -12,6 +13,7 @@ const DoubleByte SAVE_FILE_INTERRUPT_OFFSET = 0xC;
 const double MILLISECONDS_PER_FRAME = 1000.f / 59.73;
 
 const int TICKS_BETWEEN_FRAMES = 70224;
+const int TICKS_BETWEEN_INPUTS = 1000;
 
 Emulator::Emulator()
 {
@@ -46,6 +48,10 @@ void Emulator::setSaveFileName(const char* title)
 void Emulator::loadROM(const char* romName)
 {
     mCartridge.loadROM(romName, mCPU.mmu);
+
+#ifdef HERMES_PROFILE_OPCODES
+    OpcodeProfiler::start(romName);
+#endif
 }
 
 void Emulator::run()
@@ -57,19 +63,26 @@ void Emulator::run()
     {
         time1 = std::chrono::high_resolution_clock::now();
 
-        while (mCPU.getTicks() - mLastFrameTicks < TICKS_BETWEEN_FRAMES)
+        uint64_t frameEndTicks = mLastFrameTicks + TICKS_BETWEEN_FRAMES;
+        uint64_t ticks = mCPU.getTicks();
+
+        while (ticks < frameEndTicks)
         {
             // only updating the input every ~1000 ticks significantly increases the speed of the emulator with no practical
             // difference being made in terms of input delay
-            if (mCPU.getTicks() - mLastInputTicks >= 1000)
+            if (ticks - mLastInputTicks >= TICKS_BETWEEN_INPUTS)
             {
                 if (mInputHandler.handleInput(mCPU.mmu) == InputResponse::SAVE)
                     save();
 
-                mLastInputTicks = mCPU.getTicks();
+                mLastInputTicks = ticks;
             }
 
-            mCPU.emulateCycle();
+            // run the CPU in one go until either the input has to be checked again or the frame is over
+            uint64_t nextInputTicks = mLastInputTicks + TICKS_BETWEEN_INPUTS;
+            mCPU.runFor((nextInputTicks < frameEndTicks ? nextInputTicks : frameEndTicks) - ticks);
+
+            ticks = mCPU.getTicks();
         }
 
         mLastFrameTicks = mCPU.getTicks();
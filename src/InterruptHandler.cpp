@@ -3,12 +3,12 @@
 #include "InterruptHandler.h"
 
 // constants
-const DoubleByte INTERRUPTS_ENABLED_OFFSET = 0xFFFF;
 const DoubleByte INTERRUPTS_FLAGS_OFFSET   = 0xFF0F;
 
-InterruptHandler::InterruptHandler()
+InterruptHandler::InterruptHandler(bool* interruptsEnabled)
 {
-    mInterruptsEnabled = false;
+    mInterruptsEnabled = interruptsEnabled;
+    *mInterruptsEnabled = false;
 }
 
 // this function sets the PC to the point in memory designated for the interrupt that occured
@@ -22,25 +22,27 @@ void InterruptHandler::serviceInterrupt(Byte lastOpcode, Registers* registers, M
         registers->pc++;
 
     registers->sp -= 2;
-    mmu->writeDoubleByte(registers->sp, registers->pc);
+    mmu->writeStack(registers->sp, registers->pc);
     registers->pc = addr;
     disableInterrupts();
 }
 
 // checks to see if an interrupt has come in, and if it has, if we should do anything about it
-void InterruptHandler::checkInterupts(Byte lastOpcode, Registers* registers, MMU* mmu)
+bool InterruptHandler::checkInterupts(Byte lastOpcode, Registers* registers, MMU* mmu)
 {
+    // the MMU keeps track of which interrupts are both enabled and have been sent to the CPU
+    Byte pendingInterrupts = mmu->getPendingInterrupts();
+
     // only check the for interrupts IF the interrupt's are enabled at all
-    if (mInterruptsEnabled)
+    if (*mInterruptsEnabled && pendingInterrupts)
     {
-        Byte interruptsEnabled = mmu->readByte(INTERRUPTS_ENABLED_OFFSET);
-        Byte interruptsFlags   = mmu->readByte(INTERRUPTS_FLAGS_OFFSET);
+        Byte interruptsFlags = mmu->readByte(INTERRUPTS_FLAGS_OFFSET);
 
         // there are 5 possible interupts. currently, we are only checking for a VBLANK interupt
         for (int bit = 0; bit < 5; bit++)
         {
             // if the interrupt is both enabled and has been sent to the CPU
-            if ((interruptsEnabled & (1 << bit)) && (interruptsFlags & (1 << bit)))
+            if (pendingInterrupts & (1 << bit))
             {
                 // unset the interrupt flag
                 mmu->writeByte(INTERRUPTS_FLAGS_OFFSET, interruptsFlags & ~(1 << bit));
@@ -51,36 +53,38 @@ void InterruptHandler::checkInterupts(Byte lastOpcode, Registers* registers, MMU
                 {
                     case (Byte)Interrupts::VBLANK:
                         serviceInterrupt(lastOpcode, registers, mmu, 0x40);
-                        return;
+                        return true;
 
                     case (Byte)Interrupts::LCD_STAT:
                         serviceInterrupt(lastOpcode, registers, mmu, 0x48);
-                        return;
+                        return true;
 
                     case (Byte)Interrupts::TIMER:
                         serviceInterrupt(lastOpcode, registers, mmu, 0x50);
-                        return;
+                        return true;
 
                     case (Byte)Interrupts::JOYPAD:
                         serviceInterrupt(lastOpcode, registers, mmu, 0x60);
-                        return;
+                        return true;
                 }
             }
         }
     }
+
+    return false;
 }
 
 void InterruptHandler::disableInterrupts()
 {
-    mInterruptsEnabled = false;
+    *mInterruptsEnabled = false;
 }
 
 void InterruptHandler::enableInterrupts()
 {
-    mInterruptsEnabled = true;
+    *mInterruptsEnabled = true;
 }
 
 void InterruptHandler::saveDataToFile(std::ofstream& file)
 {
-    file.write((char*)&mInterruptsEnabled, 1);
+    file.write((char*)mInterruptsEnabled, 1);
 }
\ No newline at end of file
@@ -7,18 +7,20 @@
 class InterruptHandler
 {
 private:
-    bool mInterruptsEnabled;
+    // the interrupt master enable flag, which is kept in the CPU's core state
+    bool* mInterruptsEnabled;
 
     void serviceInterrupt(Byte lastOpcode, Registers* registers, MMU* mmu, Byte addr);
 
 public:
-    InterruptHandler();
+    InterruptHandler(bool* interruptsEnabled);
 
-    void checkInterupts(Byte lastOpcode, Registers* registers, MMU* mmu);
+    // returns true if an interrupt was serviced
+    bool checkInterupts(Byte lastOpcode, Registers* registers, MMU* mmu);
     void disableInterrupts();
     void enableInterrupts();
 
     void saveDataToFile(std::ofstream& file);
 
-    bool areInterruptsEnabled() { return mInterruptsEnabled; }
+    bool areInterruptsEnabled() { return *mInterruptsEnabled; }
 };
\ No newline at end of file
@@ -0,0 +1,784 @@
+#ifdef HERMES_JIT
+
+#include <cstring>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+
+#include "CPU.h"
+#include "JIT.h"
+
+// the most bytes of native code that a single instruction can turn into, including the code that handles the events after it (the
+// real maximum is a little under 600, for a conditional jump)
+const size_t MAX_NATIVE_OPCODE_SIZE = 1024;
+
+// x86-64 condition codes, used for the jumps within and out of a block
+const Byte CONDITION_BELOW          = 0x2;
+const Byte CONDITION_ABOVE_OR_EQUAL = 0x3;
+const Byte CONDITION_EQUAL          = 0x4;
+const Byte CONDITION_NOT_EQUAL      = 0x5;
+const Byte CONDITION_ALWAYS         = 0xFF; // not a real condition code, but a plain jmp
+
+// the registers that aren't selected by the opcodes in the usual way (the opcodes use 6 for (HL), which the JIT uses for F instead)
+const int REGISTER_F = 6;
+const int REGISTER_A = 7;
+
+// the opcodes from 0x80-0xBF and the ALU opcodes with an immediate (0xC6, 0xCE, ... 0xFE) select the operation in bits 3-5
+const int ALU_ADD = 0;
+const int ALU_ADC = 1;
+const int ALU_SUB = 2;
+const int ALU_SBC = 3;
+const int ALU_AND = 4;
+const int ALU_XOR = 5;
+const int ALU_OR  = 6;
+const int ALU_CP  = 7;
+
+// the same operations, as the x86-64 ALU instructions number them (the opcode extension of 0x80, and bits 3-5 of the other opcodes)
+const int X86_OPERATIONS[8] = { 0 /* add */, 2 /* adc */, 5 /* sub */, 3 /* sbb */, 4 /* and */, 6 /* xor */, 1 /* or */, 7 /* cmp */ };
+
+JIT::JIT()
+{
+    mCode = NULL;
+    mCodeSize = 0;
+}
+
+// sets aside the memory for native code and works out where the CPU's registers are, relative to the CPU itself
+void JIT::init(CPU* cpu)
+{
+    void* memory = mmap(NULL, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (memory == MAP_FAILED)
+    {
+        printf("Failed to allocate memory for the JIT!\n");
+        exit(0);
+    }
+
+    mCode = (Byte*)memory;
+
+    // the native code addresses everything relative to the CPU, which is held in rbx
+    Byte* base = (Byte*)cpu;
+    mPCOffset        = (Byte*)&cpu->mState.registers.pc - base;
+    mSPOffset        = (Byte*)&cpu->mState.registers.sp - base;
+    mTicksOffset     = (Byte*)&cpu->mState.ticks - base;
+    mNextEventOffset = (Byte*)&cpu->mState.nextEventTicks - base;
+    mLazyFlagsOffset = &cpu->mState.registers.mLazyFlags - base;
+
+    mRegisterOffsets[0] = &cpu->mState.registers.B - base;
+    mRegisterOffsets[1] = &cpu->mState.registers.C - base;
+    mRegisterOffsets[2] = &cpu->mState.registers.D - base;
+    mRegisterOffsets[3] = &cpu->mState.registers.E - base;
+    mRegisterOffsets[4] = &cpu->mState.registers.H - base;
+    mRegisterOffsets[5] = &cpu->mState.registers.L - base;
+    mRegisterOffsets[6] = &cpu->mState.registers.F - base;
+    mRegisterOffsets[7] = &cpu->mState.registers.A - base;
+}
+
+void JIT::updateComponents(CPU* cpu, int opcode, int deltaTicks)
+{
+    cpu->updateComponents(opcode, deltaTicks);
+}
+
+// the native code keeps F up to date itself, so any flags that a handler left pending are worked out as soon as it returns
+void JIT::resolveFlags(CPU* cpu)
+{
+    cpu->mState.registers.resolveFlags();
+}
+
+/*
+    the registers are kept in host registers that calls are allowed to overwrite (they are written back before a call and read again
+    after it anyway), which leaves rbx (the CPU), r12 (the ticks), r13 (the tick limit), r14 (the tick that events have to be checked
+    at), r15 (the address of the block cache's version) and rbp (the ticks before an instruction whose handler adds its own) untouched
+    by calls. rax and rbp are used as scratch registers by the native opcodes
+*/
+int JIT::hostRegister(int reg)
+{
+    static const int HOST_REGISTERS[8] = { RCX, RDX, RSI, RDI, R8, R9, R11, R10 }; // B, C, D, E, H, L, F, A
+    return HOST_REGISTERS[reg];
+}
+
+void JIT::emitByte(Byte val)
+{
+    mCode[mCodeSize++] = val;
+}
+
+void JIT::emitBytes(const char* bytes, size_t size)
+{
+    memcpy(mCode + mCodeSize, bytes, size);
+    mCodeSize += size;
+}
+
+void JIT::emitInt16(DoubleByte val)
+{
+    memcpy(mCode + mCodeSize, &val, 2);
+    mCodeSize += 2;
+}
+
+void JIT::emitInt32(uint32_t val)
+{
+    memcpy(mCode + mCodeSize, &val, 4);
+    mCodeSize += 4;
+}
+
+void JIT::emitInt64(uint64_t val)
+{
+    memcpy(mCode + mCodeSize, &val, 8);
+    mCodeSize += 8;
+}
+
+// byte instructions always get a REX prefix, so that registers 4-7 are spl, bpl, sil and dil (instead of ah, ch, dh and bh)
+void JIT::emitRegister(const char* opcode, size_t opcodeSize, int reg, int rm, OperandSize size)
+{
+    if (size == WORD)
+        emitByte(0x66);
+
+    Byte rex = 0x40 | (size == QWORD ? 0x8 : 0) | ((reg & 8) ? 0x4 : 0) | ((rm & 8) ? 0x1 : 0);
+    if (rex != 0x40 || size == BYTE)
+        emitByte(rex);
+
+    emitBytes(opcode, opcodeSize);
+    emitByte(0xC0 | ((reg & 7) << 3) | (rm & 7));
+}
+
+void JIT::emitMember(const char* opcode, size_t opcodeSize, int reg, int32_t offset, OperandSize size)
+{
+    if (size == WORD)
+        emitByte(0x66);
+
+    Byte rex = 0x40 | (size == QWORD ? 0x8 : 0) | ((reg & 8) ? 0x4 : 0);
+    if (rex != 0x40 || size == BYTE)
+        emitByte(rex);
+
+    emitBytes(opcode, opcodeSize);
+    emitByte(0x80 | ((reg & 7) << 3) | RBX); // [rbx + offset]
+    emitInt32(offset);
+}
+
+void JIT::emitTableLoad(int dst, const Byte* table)
+{
+    emitBytes("\x48\xB8", 2); // mov rax, table
+    emitInt64((uint64_t)table);
+
+    if (dst & 8)
+        emitByte(0x44);
+    emitBytes("\x0F\xB6", 2); // movzx dst, byte [rax + rbp]
+    emitByte(0x04 | ((dst & 7) << 3));
+    emitByte(0x28);
+}
+
+void JIT::emitCall(const void* function)
+{
+    emitBytes("\x48\xB8", 2); // mov rax, function
+    emitInt64((uint64_t)function);
+    emitBytes("\xFF\xD0", 2); // call rax
+}
+
+size_t JIT::emitJump(Byte condition)
+{
+    if (condition == CONDITION_ALWAYS)
+        emitByte(0xE9);       // jmp rel32
+    else
+    {
+        emitByte(0x0F);       // jcc rel32
+        emitByte(0x80 | condition);
+    }
+
+    emitInt32(0);
+    return mCodeSize - 4;
+}
+
+void JIT::patchJump(size_t jump)
+{
+    int32_t offset = mCodeSize - (jump + 4);
+    memcpy(mCode + jump, &offset, 4);
+}
+
+void JIT::emitExitJump(Byte condition)
+{
+    mExitJumps.push_back(emitJump(condition));
+}
+
+void JIT::emitLoadRegisters()
+{
+    for (int reg = 0; reg < 8; reg++)
+        emitMember("\x0F\xB6", 2, hostRegister(reg), mRegisterOffsets[reg], BYTE); // movzx reg, byte [rbx + register]
+
+    mDirtyRegisters = 0;
+}
+
+void JIT::emitStoreRegisters()
+{
+    for (int reg = 0; reg < 8; reg++)
+        if (mDirtyRegisters & (1 << reg))
+            emitMember("\x88", 1, hostRegister(reg), mRegisterOffsets[reg], BYTE); // mov byte [rbx + register], reg
+
+    mDirtyRegisters = 0;
+}
+
+void JIT::emitWriteBack(DoubleByte pc)
+{
+    emitStoreRegisters();
+
+    emitMember("\x89", 1, R12, mTicksOffset, QWORD); // mov [rbx + ticks], r12
+
+    emitMember("\xC7", 1, 0, mPCOffset, WORD);       // mov word [rbx + pc], pc
+    emitInt16(pc);
+}
+
+void JIT::emitAfterCall()
+{
+    emitMember("\x8B", 1, R12, mTicksOffset, QWORD); // mov r12, [rbx + ticks]
+
+    emitMember("\x80", 1, 7, mLazyFlagsOffset, BYTE); // cmp byte [rbx + lazy flags], 0
+    emitByte(0);
+    emitBytes("\x74\x00", 2);                        // je (past the call, filled in once it has been emitted)
+    size_t skipJump = mCodeSize;
+
+    emitBytes("\x48\x89\xDF", 3);                    // mov rdi, rbx
+    emitCall((const void*)&JIT::resolveFlags);
+    mCode[skipJump - 1] = mCodeSize - skipJump;
+
+    emitLoadRegisters();
+}
+
+void JIT::emitLimit()
+{
+    emitMember("\x8B", 1, R14, mNextEventOffset, QWORD); // mov r14, [rbx + next event]
+    emitBytes("\x4D\x39\xEE", 3);                        // cmp r14, r13
+    emitBytes("\x4D\x0F\x47\xF5", 4);                    // cmova r14, r13
+}
+
+void JIT::emitUpdateComponents(Byte opcode, Byte ticks)
+{
+    // the profiler has to see every instruction, so then updateComponents is always called
+#ifndef HERMES_PROFILE_OPCODES
+    emitMember("\x3B", 1, R12, mNextEventOffset, QWORD); // cmp r12, [rbx + next event]
+    size_t skipJump = emitJump(CONDITION_BELOW);
+#endif
+
+    emitBytes("\x48\x89\xDF", 3); // mov rdi, rbx
+    emitByte(0xBE);               // mov esi, opcode
+    emitInt32(opcode);
+
+    if (ticks == 0)
+    {
+        emitBytes("\x4C\x89\xE2", 3); // mov rdx, r12
+        emitBytes("\x48\x29\xEA", 3); // sub rdx, rbp
+    }
+    else
+    {
+        emitByte(0xBA);               // mov edx, ticks
+        emitInt32(ticks);
+    }
+
+    emitCall((const void*)&JIT::updateComponents);
+    emitAfterCall();
+
+#ifndef HERMES_PROFILE_OPCODES
+    patchJump(skipJump);
+#endif
+}
+
+void JIT::emitExitChecks(DoubleByte pc)
+{
+    emitMember("\x81", 1, 7, mPCOffset, WORD);       // cmp word [rbx + pc], pc
+    emitInt16(pc);
+    emitExitJump(CONDITION_NOT_EQUAL);
+
+    emitBytes("\x4D\x39\xEC", 3);                    // cmp r12, r13
+    emitExitJump(CONDITION_ABOVE_OR_EQUAL);
+
+    emitBytes("\x41\x8B\x07", 3);                    // mov eax, [r15]
+    emitBytes("\x3B\x04\x24", 3);                    // cmp eax, [rsp] (the version the block started with)
+    emitExitJump(CONDITION_NOT_EQUAL);
+
+    // an event (or the handler before it) could have scheduled another one
+    emitLimit();
+}
+
+// after an instruction that was translated into native code, all there is to do is check whether an event is due (or the tick limit
+// has been reached). handling that is put at the end of the block, out of the way
+void JIT::emitEventCheck(const MicroOp& op, DoubleByte pc)
+{
+    EventCheck check;
+
+#ifdef HERMES_PROFILE_OPCODES
+    check.jump = emitJump(CONDITION_ALWAYS);
+#else
+    emitBytes("\x4D\x39\xF4", 3); // cmp r12, r14
+    check.jump = emitJump(CONDITION_ABOVE_OR_EQUAL);
+#endif
+
+    check.resume = mCodeSize;
+    check.pc = pc;
+    check.opcode = op.opcode;
+    check.ticks = op.ticks;
+    check.dirtyRegisters = mDirtyRegisters;
+
+    mEventChecks.push_back(check);
+}
+
+void JIT::emitEventHandling(const EventCheck& check)
+{
+    patchJump(check.jump);
+
+    mDirtyRegisters = check.dirtyRegisters;
+    emitWriteBack(check.pc);
+
+    emitBytes("\x48\x89\xDF", 3); // mov rdi, rbx
+    emitByte(0xBE);               // mov esi, opcode
+    emitInt32(check.opcode);
+    emitByte(0xBA);               // mov edx, ticks
+    emitInt32(check.ticks);
+    emitCall((const void*)&JIT::updateComponents);
+    emitAfterCall();
+
+    emitExitChecks(check.pc);
+
+    int32_t offset = check.resume - (mCodeSize + 5);
+    emitByte(0xE9);               // jmp back into the block
+    emitInt32(offset);
+}
+
+void JIT::emitHandlerCall(const MicroOp& op, DoubleByte pc, bool last)
+{
+    // if the handler adds the instruction's ticks itself (because they depend on a condition), then the ticks from before it ran are
+    // kept so that the difference can be worked out afterwards
+    if (op.ticks == 0)
+        emitBytes("\x4C\x89\xE5", 3);       // mov rbp, r12
+    else
+    {
+        emitRegister("\x83", 1, 0, R12, QWORD); // add r12, ticks
+        emitByte(op.ticks);
+    }
+
+    emitWriteBack(pc);
+
+    emitBytes("\x48\x89\xDF", 3); // mov rdi, rbx
+    emitByte(0xBE);               // mov esi, operand
+    emitInt32(op.operand);
+    emitCall((const void*)op.handler);
+    emitAfterCall();
+
+    emitUpdateComponents(op.opcode, op.ticks);
+
+    if (last)
+        emitExitJump(CONDITION_ALWAYS);
+    else
+        emitExitChecks(pc);
+}
+
+/*
+    ADD, SUB and CP look their flags up in the same tables as the interpreter, indexed by A and the value (in rbp). ADC and SBC take
+    the zero and carry flags from the host's flags instead, and work the half-carry flag out from bit 4 of A ^ value ^ result.
+    AND, XOR and OR only set the zero flag (and AND the half-carry flag)
+*/
+void JIT::emitALU(int operation, int source, Byte immediate)
+{
+    int a = hostRegister(REGISTER_A);
+    int f = hostRegister(REGISTER_F);
+    char x86Opcode = X86_OPERATIONS[operation] << 3;
+
+    if (operation == ALU_ADD || operation == ALU_SUB || operation == ALU_CP)
+    {
+        emitRegister("\x89", 1, a, RBP, DWORD);     // mov ebp, a
+        emitRegister("\xC1", 1, 4, RBP, DWORD);     // shl ebp, 8
+        emitByte(8);
+
+        if (source == -1)
+        {
+            emitRegister("\x81", 1, 1, RBP, DWORD); // or ebp, immediate
+            emitInt32(immediate);
+        }
+        else
+            emitRegister("\x09", 1, hostRegister(source), RBP, DWORD); // or ebp, source
+
+        emitTableLoad(f, operation == ALU_ADD ? ADD_FLAGS.data() : SUB_FLAGS.data());
+    }
+
+    // A ^ value is worked out before the operation, as the value could be A itself
+    if (operation == ALU_ADC || operation == ALU_SBC)
+    {
+        emitRegister("\x89", 1, a, RBP, DWORD);     // mov ebp, a
+
+        if (source == -1)
+        {
+            emitRegister("\x81", 1, 6, RBP, DWORD); // xor ebp, immediate
+            emitInt32(immediate);
+        }
+        else
+            emitRegister("\x31", 1, hostRegister(source), RBP, DWORD); // xor ebp, source
+
+        emitRegister("\x0F\xBA", 2, 4, f, DWORD);   // bt f, 4 (copying the carry flag into the host's carry flag)
+        emitByte(4);
+    }
+
+    // the operation itself
+    if (operation != ALU_CP)
+    {
+        if (source == -1)
+        {
+            emitRegister("\x80", 1, X86_OPERATIONS[operation], a, BYTE); // op a, immediate
+            emitByte(immediate);
+        }
+        else
+            emitRegister(&x86Opcode, 1, hostRegister(source), a, BYTE); // op a, source
+    }
+
+    if (operation == ALU_ADC || operation == ALU_SBC)
+    {
+        emitRegister("\x0F\x92", 2, 0, RAX, BYTE);  // setc al
+        emitRegister("\x0F\x94", 2, 0, f, BYTE);    // setz f
+        emitRegister("\xC1", 1, 4, f, DWORD);       // shl f, 7
+        emitByte(7);
+        emitRegister("\x0F\xB6", 2, RAX, RAX, BYTE); // movzx eax, al
+        emitRegister("\xC1", 1, 4, RAX, DWORD);     // shl eax, 4
+        emitByte(4);
+        emitRegister("\x09", 1, RAX, f, DWORD);     // or f, eax
+
+        emitRegister("\x31", 1, a, RBP, DWORD);     // xor ebp, a
+        emitRegister("\x83", 1, 4, RBP, DWORD);     // and ebp, 0x10
+        emitByte(0x10);
+        emitRegister("\xD1", 1, 4, RBP, DWORD);     // shl ebp, 1
+        emitRegister("\x09", 1, RBP, f, DWORD);     // or f, ebp
+
+        if (operation == ALU_SBC)
+        {
+            emitRegister("\x83", 1, 1, f, DWORD);   // or f, NEGATIVE_FLAG
+            emitByte(NEGATIVE_FLAG);
+        }
+    }
+
+    if (operation == ALU_AND || operation == ALU_XOR || operation == ALU_OR)
+    {
+        emitRegister("\x0F\x94", 2, 0, RAX, BYTE);  // setz al
+        emitRegister("\x0F\xB6", 2, f, RAX, BYTE);  // movzx f, al
+        emitRegister("\xC1", 1, 4, f, DWORD);       // shl f, 7
+        emitByte(7);
+
+        if (operation == ALU_AND)
+        {
+            emitRegister("\x83", 1, 1, f, DWORD);   // or f, HALF_CARRY_FLAG
+            emitByte(HALF_CARRY_FLAG);
+        }
+    }
+
+    mDirtyRegisters |= (1 << REGISTER_A) | (1 << REGISTER_F);
+}
+
+bool JIT::emitNativeOpcode(const MicroOp& op)
+{
+    Byte opcode = op.opcode;
+    int f = hostRegister(REGISTER_F);
+
+    // opcode 0x00, NOP
+    if (opcode == 0x00)
+        return true;
+
+    // opcodes 0x40-0x7F (except HALT and anything involving (HL)), LD_R_R: load one register into another
+    if (opcode >= 0x40 && opcode <= 0x7F && ((opcode >> 3) & 7) != 6 && (opcode & 7) != 6)
+    {
+        int destination = (opcode >> 3) & 7;
+        int source      = opcode & 7;
+
+        if (destination != source)
+        {
+            emitRegister("\x88", 1, hostRegister(source), hostRegister(destination), BYTE); // mov destination, source
+            mDirtyRegisters |= 1 << destination;
+        }
+        return true;
+    }
+
+    // opcodes 0x06, 0x0E, 0x16, 0x1E, 0x26, 0x2E and 0x3E, LD_R_N: load the operand into a register
+    if (opcode <= 0x3E && (opcode & 7) == 6 && opcode != 0x36)
+    {
+        emitRegister("\xC6", 1, 0, hostRegister(opcode >> 3), BYTE); // mov register, operand
+        emitByte(op.operand);
+        mDirtyRegisters |= 1 << (opcode >> 3);
+        return true;
+    }
+
+    // opcodes 0x01, 0x11, 0x21 and 0x31, LD_RR_NN: load the operand into a 16-bit register
+    // opcodes 0x03, 0x13, 0x23 and 0x33, INC_RR, and 0x0B, 0x1B, 0x2B and 0x3B, DEC_RR: increment or decrement a 16-bit register
+    if (opcode <= 0x3B && ((opcode & 0xF) == 0x1 || (opcode & 0xF) == 0x3 || (opcode & 0xF) == 0xB))
+    {
+        Byte low = opcode & 0xF;
+
+        // the stack pointer isn't kept in a host register, so it is changed in place
+        if (opcode >> 4 == 3)
+        {
+            if (low == 0x1)
+            {
+                emitMember("\xC7", 1, 0, mSPOffset, WORD); // mov word [rbx + sp], operand
+                emitInt16(op.operand);
+            }
+            else
+            {
+                emitMember("\x83", 1, low == 0x3 ? 0 : 5, mSPOffset, WORD); // add (or sub) word [rbx + sp], 1
+                emitByte(1);
+            }
+            return true;
+        }
+
+        // the upper register comes first (B, D and H), then the lower one (C, E and L)
+        int upper = (opcode >> 4) * 2;
+        int lower = upper + 1;
+
+        if (low == 0x1)
+        {
+            emitRegister("\xC6", 1, 0, hostRegister(lower), BYTE); // mov lower, operand & 0xFF
+            emitByte(op.operand & 0xFF);
+            emitRegister("\xC6", 1, 0, hostRegister(upper), BYTE); // mov upper, operand >> 8
+            emitByte(op.operand >> 8);
+        }
+        else
+        {
+            // the carry (or borrow) out of the lower register is added to (or subtracted from) the upper one
+            emitRegister("\x80", 1, low == 0x3 ? 0 : 5, hostRegister(lower), BYTE); // add (or sub) lower, 1
+            emitByte(1);
+            emitRegister("\x80", 1, low == 0x3 ? 2 : 3, hostRegister(upper), BYTE); // adc (or sbb) upper, 0
+            emitByte(0);
+        }
+
+        mDirtyRegisters |= (1 << upper) | (1 << lower);
+        return true;
+    }
+
+    // opcodes 0x04, 0x0C, ... 0x3C, INC_R, and 0x05, 0x0D, ... 0x3D, DEC_R (except for (HL)): the flags are looked up in the
+    // same tables as the interpreter uses, and the carry flag is left alone
+    if (opcode <= 0x3D && ((opcode & 7) == 4 || (opcode & 7) == 5) && opcode != 0x34 && opcode != 0x35)
+    {
+        int reg = opcode >> 3;
+        bool decrement = opcode & 1;
+
+        emitRegister("\x89", 1, hostRegister(reg), RBP, DWORD); // mov ebp, register
+        emitTableLoad(RAX, decrement ? DEC_FLAGS.data() : INC_FLAGS.data());
+        emitRegister("\x83", 1, 4, f, DWORD);                    // and f, CARRY_FLAG
+        emitByte(CARRY_FLAG);
+        emitRegister("\x09", 1, RAX, f, DWORD);                  // or f, eax
+        emitRegister("\x80", 1, decrement ? 5 : 0, hostRegister(reg), BYTE); // add (or sub) register, 1
+        emitByte(1);
+
+        mDirtyRegisters |= (1 << reg) | (1 << REGISTER_F);
+        return true;
+    }
+
+    // opcodes 0x80-0xBF (except for (HL)): ADD, ADC, SUB, SBC, AND, XOR, OR and CP with a register
+    if (opcode >= 0x80 && opcode <= 0xBF && (opcode & 7) != 6)
+    {
+        emitALU((opcode >> 3) & 7, opcode & 7, 0);
+        return true;
+    }
+
+    // opcodes 0xC6, 0xCE, ... 0xFE: the same, with the operand
+    if (opcode >= 0xC6 && (opcode & 7) == 6)
+    {
+        emitALU((opcode >> 3) & 7, -1, op.operand);
+        return true;
+    }
+
+    // CB-prefixed opcodes 0x40-0x7F (except for (HL)), BIT_B_R: set the zero flag if the bit is clear, leaving the carry flag alone
+    if (opcode == 0xCB && (op.operand & 0xC0) == 0x40 && (op.operand & 7) != 6)
+    {
+        emitRegister("\xF6", 1, 0, hostRegister(op.operand & 7), BYTE); // test register, 1 << bit
+        emitByte(1 << ((op.operand >> 3) & 7));
+        emitRegister("\x0F\x94", 2, 0, RAX, BYTE);   // setz al
+        emitRegister("\x0F\xB6", 2, RAX, RAX, BYTE); // movzx eax, al
+        emitRegister("\xC1", 1, 4, RAX, DWORD);      // shl eax, 7
+        emitByte(7);
+        emitRegister("\x83", 1, 4, f, DWORD);        // and f, CARRY_FLAG
+        emitByte(CARRY_FLAG);
+        emitRegister("\x83", 1, 1, f, DWORD);        // or f, HALF_CARRY_FLAG
+        emitByte(HALF_CARRY_FLAG);
+        emitRegister("\x09", 1, RAX, f, DWORD);      // or f, eax
+
+        mDirtyRegisters |= 1 << REGISTER_F;
+        return true;
+    }
+
+    // opcode 0x2F, CPL: flip every bit of A, and set the negative and half-carry flags
+    if (opcode == 0x2F)
+    {
+        emitRegister("\x80", 1, 6, hostRegister(REGISTER_A), BYTE); // xor a, 0xFF
+        emitByte(0xFF);
+        emitRegister("\x83", 1, 1, f, DWORD);                       // or f, NEGATIVE_FLAG | HALF_CARRY_FLAG
+        emitByte(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+
+        mDirtyRegisters |= (1 << REGISTER_A) | (1 << REGISTER_F);
+        return true;
+    }
+
+    // opcode 0x37, SCF, and 0x3F, CCF: set (or flip) the carry flag, and clear the negative and half-carry flags
+    if (opcode == 0x37 || opcode == 0x3F)
+    {
+        if (opcode == 0x37)
+        {
+            emitRegister("\x83", 1, 1, f, DWORD); // or f, CARRY_FLAG
+            emitByte(CARRY_FLAG);
+        }
+        else
+        {
+            emitRegister("\x83", 1, 6, f, DWORD); // xor f, CARRY_FLAG
+            emitByte(CARRY_FLAG);
+        }
+
+        emitRegister("\x83", 1, 4, f, DWORD);     // and f, ZERO_FLAG | CARRY_FLAG
+        emitByte(ZERO_FLAG | CARRY_FLAG);
+
+        mDirtyRegisters |= 1 << REGISTER_F;
+        return true;
+    }
+
+    return false;
+}
+
+// leaves the block for target, once the jump's ticks have been added (and any events that are due have been handled)
+void JIT::emitBranch(const MicroOp& op, DoubleByte target, Byte ticks)
+{
+    emitRegister("\x83", 1, 0, R12, QWORD); // add r12, ticks
+    emitByte(ticks);
+
+    emitWriteBack(target);
+    emitUpdateComponents(op.opcode, ticks);
+    emitExitJump(CONDITION_ALWAYS);
+}
+
+// JR and JP always end a block, so the native code leaves the block straight from them
+bool JIT::emitJumpOpcode(const MicroOp& op, DoubleByte pc)
+{
+    DoubleByte relativeTarget = pc + (Signedbyte)op.operand;
+
+    switch (op.opcode)
+    {
+        // opcode 0x18, JR_N, and 0xC3, JP_NN
+        case 0x18: emitBranch(op, relativeTarget, 12); return true;
+        case 0xC3: emitBranch(op, op.operand, 16);     return true;
+
+        // opcode 0xE9, JP_(HL)
+        case 0xE9:
+        {
+            emitRegister("\x83", 1, 0, R12, QWORD);                  // add r12, 4
+            emitByte(4);
+
+            emitStoreRegisters();
+            emitMember("\x89", 1, R12, mTicksOffset, QWORD);         // mov [rbx + ticks], r12
+
+            emitRegister("\x89", 1, hostRegister(4), RAX, DWORD);    // mov eax, h
+            emitRegister("\xC1", 1, 4, RAX, DWORD);                  // shl eax, 8
+            emitByte(8);
+            emitRegister("\x09", 1, hostRegister(5), RAX, DWORD);    // or eax, l
+            emitMember("\x89", 1, RAX, mPCOffset, WORD);             // mov [rbx + pc], ax
+
+            emitUpdateComponents(op.opcode, 4);
+            emitExitJump(CONDITION_ALWAYS);
+            return true;
+        }
+
+        default:
+            break;
+    }
+
+    // the conditional jumps test the zero flag (0x20, 0x28, 0xC2 and 0xCA) or the carry flag (0x30, 0x38, 0xD2 and 0xDA), and jump
+    // if it is clear (bit 3 of the opcode is 0) or set (bit 3 is 1)
+    bool relative = op.opcode == 0x20 || op.opcode == 0x28 || op.opcode == 0x30 || op.opcode == 0x38;
+    bool absolute = op.opcode == 0xC2 || op.opcode == 0xCA || op.opcode == 0xD2 || op.opcode == 0xDA;
+
+    if (!relative && !absolute)
+        return false;
+
+    emitRegister("\xF6", 1, 0, hostRegister(REGISTER_F), BYTE); // test f, flag
+    emitByte((op.opcode & 0x10) ? CARRY_FLAG : ZERO_FLAG);
+
+    // skip to the jump not being taken if the flag isn't what the opcode wants
+    size_t notTakenJump = emitJump((op.opcode & 0x8) ? CONDITION_EQUAL : CONDITION_NOT_EQUAL);
+    Byte dirtyRegisters = mDirtyRegisters;
+
+    emitBranch(op, relative ? relativeTarget : op.operand, relative ? 12 : 16);
+
+    patchJump(notTakenJump);
+    mDirtyRegisters = dirtyRegisters;
+
+    emitBranch(op, pc, relative ? 8 : 12);
+    return true;
+}
+
+void JIT::compile(Block& block)
+{
+    // make sure there is enough room left for the whole block
+    if (mCodeSize + (block.ops.size() + 1) * MAX_NATIVE_OPCODE_SIZE > CODE_BUFFER_SIZE)
+        return;
+
+    mprotect(mCode, CODE_BUFFER_SIZE, PROT_READ | PROT_WRITE);
+
+    size_t start = mCodeSize;
+    mExitJumps.clear();
+    mEventChecks.clear();
+
+    // save the registers that calls leave alone (pushing 6 registers and then making room for the starting version on the stack keeps
+    // it aligned to 16 bytes for the calls into the CPU)
+    emitBytes("\x53\x55\x41\x54\x41\x55\x41\x56\x41\x57", 10); // push rbx, rbp, r12, r13, r14 and r15
+    emitBytes("\x48\x83\xEC\x08", 4); // sub rsp, 8
+    emitBytes("\x48\x89\xFB", 3);     // mov rbx, rdi
+    emitBytes("\x49\x89\xF5", 3);     // mov r13, rsi
+    emitBytes("\x49\x89\xD7", 3);     // mov r15, rdx
+    emitBytes("\x41\x8B\x07", 3);     // mov eax, [r15]
+    emitBytes("\x89\x04\x24", 3);     // mov [rsp], eax
+    emitMember("\x8B", 1, R12, mTicksOffset, QWORD); // mov r12, [rbx + ticks]
+
+    emitLimit();
+    emitLoadRegisters();
+
+    DoubleByte pc = block.startAddr;
+    for (size_t index = 0; index < block.ops.size(); index++)
+    {
+        const MicroOp& op = block.ops[index];
+
+        // the instructions of a superinstruction follow it in the block, and are translated on their own instead
+        if (op.fusedOps)
+            continue;
+
+        pc += op.length;
+        bool last = index == block.ops.size() - 1;
+
+        if (last && emitJumpOpcode(op, pc))
+            break;
+
+        if (!emitNativeOpcode(op))
+        {
+            emitHandlerCall(op, pc, last);
+            continue;
+        }
+
+        emitRegister("\x83", 1, 0, R12, QWORD); // add r12, ticks
+        emitByte(op.ticks);
+
+        // the last instruction leaves the block no matter what, so it doesn't need to check anything else
+        if (last)
+        {
+            emitWriteBack(pc);
+            emitUpdateComponents(op.opcode, op.ticks);
+            emitExitJump(CONDITION_ALWAYS);
+        }
+        else
+            emitEventCheck(op, pc);
+    }
+
+    // everything is written back to the CPU before any jump out of the block, so all that is left is to restore the registers that were saved
+    size_t exit = mCodeSize;
+    emitBytes("\x48\x83\xC4\x08", 4); // add rsp, 8
+    emitBytes("\x41\x5F\x41\x5E\x41\x5D\x41\x5C\x5D\x5B\xC3", 11); // pop r15, r14, r13, r12, rbp and rbx, then ret
+
+    for (const EventCheck& check : mEventChecks)
+        emitEventHandling(check);
+
+    for (size_t jump : mExitJumps)
+    {
+        int32_t offset = exit - (jump + 4);
+        memcpy(mCode + jump, &offset, 4);
+    }
+
+    mprotect(mCode, CODE_BUFFER_SIZE, PROT_READ | PROT_EXEC);
+
+    block.nativeCode = mCode + start;
+}
+
+#endif
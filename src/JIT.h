@@ -0,0 +1,137 @@
+#pragma once
+
+#ifdef HERMES_JIT
+
+#if !defined(__x86_64__) || !defined(__unix__)
+#error "the JIT (HERMES_JIT) is only supported on x86-64 unix systems"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "BlockCache.h"
+#include "Constants.h"
+
+class CPU;
+
+/*
+    the JIT translates blocks of ROM code that are ran often into native x86-64 code. the gameboy's 8-bit registers (A, F, B, C, D, E,
+    H and L) are each kept in a host register for the whole block, and the tick count is kept in another. loads between registers,
+    the ALU opcodes (working out the flags with the same tables as the interpreter, or with the host's own carry and zero flags), INC,
+    DEC, BIT, CPL, SCF, CCF and the jumps that end blocks (JR and JP) are all translated into native code that only touches those
+    registers. anything else (mostly opcodes that access memory, which has to go through the MMU) is ran by calling its handler,
+    with the registers written back to the CPU beforehand and read again afterwards.
+
+    after each instruction the tick count is compared against the earliest of the scheduler's next event (see Scheduler.h) and the tick
+    limit. only if that is reached does the native code write everything back and call into the CPU to handle the events, exactly like
+    the interpreter does after the same instruction, so the timing is identical. the native code returns to the interpreter as soon as
+    the program counter goes somewhere unexpected (an interrupt), the tick limit is reached or the block cache is invalidated (a bank
+    switch or a write over cached RAM code). code in RAM is never translated, as it can be changed at any time
+*/
+class JIT
+{
+private:
+    // how much memory is set aside for native code. once it is full, no more blocks are translated
+    static const size_t CODE_BUFFER_SIZE = 16 * 1024 * 1024;
+
+    // the x86-64 registers, numbered the way that instructions encode them
+    enum HostRegister { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+
+    enum OperandSize { BYTE, WORD, DWORD, QWORD };
+
+    Byte* mCode;
+    size_t mCodeSize;
+
+    // the offsets of the CPU's members that the native code reads and writes directly
+    int32_t mPCOffset;
+    int32_t mTicksOffset;
+    int32_t mNextEventOffset;
+    int32_t mSPOffset;
+    int32_t mLazyFlagsOffset;
+    int32_t mRegisterOffsets[8]; // indexed the same way the opcodes index registers (B, C, D, E, H, L, (HL), A), except that 6 is F
+
+    // one bit for each of the registers above that has been changed by native code since it was last written back to the CPU
+    Byte mDirtyRegisters;
+
+    // where the jumps out of the block currently being translated are, so they can be pointed at the block's exit once it is known
+    std::vector<size_t> mExitJumps;
+
+    // the events that are due after an instruction that was translated into native code are handled out of the way of the rest of the
+    // block (as they rarely are), so where each of those jumps out is (and everything needed to handle the events) is kept until then
+    struct EventCheck
+    {
+        size_t jump;    // the jump to the code that handles the events
+        size_t resume;  // where the block carries on afterwards
+        DoubleByte pc;  // the program counter after the instruction
+        Byte opcode;
+        Byte ticks;
+        Byte dirtyRegisters;
+    };
+
+    std::vector<EventCheck> mEventChecks;
+
+    void emitByte(Byte val);
+    void emitBytes(const char* bytes, size_t size);
+    void emitInt16(DoubleByte val);
+    void emitInt32(uint32_t val);
+    void emitInt64(uint64_t val);
+
+    // emits an instruction with the given opcode, with reg in the reg field (or the opcode extension) and rm as a register
+    void emitRegister(const char* opcode, size_t opcodeSize, int reg, int rm, OperandSize size);
+
+    // emits an instruction with the given opcode, with reg in the reg field (or the opcode extension) and a member of the CPU as rm
+    void emitMember(const char* opcode, size_t opcodeSize, int reg, int32_t offset, OperandSize size);
+
+    // loads table[rbp] into dst (zero extended)
+    void emitTableLoad(int dst, const Byte* table);
+
+    void emitCall(const void* function);
+    void emitExitJump(Byte condition);  // emits a jump (with the given condition code) to the end of the block
+    size_t emitJump(Byte condition);    // emits a jump that is pointed somewhere later on with patchJump
+    void patchJump(size_t jump);        // points a jump from emitJump at the code that is about to be emitted
+
+    // the host register that holds the given register (using the same numbering as mRegisterOffsets)
+    static int hostRegister(int reg);
+
+    void emitLoadRegisters();             // reads every register from the CPU
+    void emitStoreRegisters();            // writes every dirty register back to the CPU
+    void emitWriteBack(DoubleByte pc);    // writes the registers, the ticks and the given program counter back to the CPU
+    void emitAfterCall();                 // reads the ticks and the registers back in after calling into the CPU
+    void emitLimit();                     // works out the tick that the events have to be checked at again
+
+    // calls updateComponents if an event is due (ticks of 0 meaning the instruction's ticks are worked out from the ticks before it, in rbp)
+    void emitUpdateComponents(Byte opcode, Byte ticks);
+
+    // leaves the block if an interrupt moved the program counter away from pc, if enough ticks went by or if the block is no longer valid
+    void emitExitChecks(DoubleByte pc);
+
+    void emitEventCheck(const MicroOp& op, DoubleByte pc);
+    void emitEventHandling(const EventCheck& check);
+
+    void emitHandlerCall(const MicroOp& op, DoubleByte pc, bool last);
+    void emitALU(int operation, int source, Byte immediate); // source is -1 for the immediate versions of the opcodes
+    bool emitNativeOpcode(const MicroOp& op);                // returns false if the opcode has to be ran by its handler
+    bool emitJumpOpcode(const MicroOp& op, DoubleByte pc);   // returns false if the opcode isn't a JR or JP
+    void emitBranch(const MicroOp& op, DoubleByte target, Byte ticks);
+
+    // the native code calls back into the CPU through these functions
+    static void updateComponents(CPU* cpu, int opcode, int deltaTicks);
+    static void resolveFlags(CPU* cpu);
+
+public:
+    // how many times a block has to be ran before it gets translated
+    static const uint32_t HOT_BLOCK_THRESHOLD = 64;
+
+    // native blocks are called with the CPU, the tick limit and the block cache's version. the flags have to be resolved beforehand
+    typedef void (*NativeBlock)(CPU* cpu, uint64_t maxTicks, const uint32_t* version);
+
+    JIT();
+
+    void init(CPU* cpu);
+
+    // translates the block into native code (leaving it to the interpreter if there is no room left)
+    void compile(Block& block);
+};
+
+#endif
@@ -1,6 +1,13 @@
 #include "Display.h"
 #include "InputHandler.h"
 #include "MMU.h"
+#include "PPU.h"
+
+#include "MemoryChips/MBC1.h"
+#include "MemoryChips/MBC2.h"
+#include "MemoryChips/MBC3.h"
+#include "MemoryChips/MBC5.h"
+#include "MemoryChips/ROMOnly.h"
 
 #include <cstring>
 
@@ -9,32 +16,82 @@ const DoubleByte SPRITE_DATA_OFFSET  = 0xFE00;
 const DoubleByte OAM_DMA_OFFSET      = 0xFF46;
 const DoubleByte JOYPAD_OFFSET       = 0xFF00;
 
-// timer offsets
-const DoubleByte DIV_REGISTER_OFFSET = 0xFF04;
-const DoubleByte TAC_REGISTER_OFFSET = 0xFF07; 
+// an OAM DMA transfer copies 160 bytes, one per machine cycle
+const DoubleByte OAM_DMA_SIZE  = 0xA0;
+const int        OAM_DMA_TICKS = 640;
+
+// the interrupt enable (IE) register
+const DoubleByte INTERRUPTS_ENABLED_OFFSET = 0xFFFF;
 
 // save file offsets
 const DoubleByte SAVE_FILE_RAM_OFFSET_START = 0xD;
 
-// reads a single bye from memory
+// returns whether the address is in VRAM or OAM, which the PPU renders scanlines from
+static bool isReadByRenderer(DoubleByte addr)
+{
+    return (addr >= 0x8000 && addr <= 0x9FFF) || (addr >= SPRITE_DATA_OFFSET && addr < SPRITE_DATA_OFFSET + 0xA0);
+}
+
+static bool isIORegister(DoubleByte addr)
+{
+    return addr >= IO_REGISTERS_OFFSET && addr < IO_REGISTERS_OFFSET + IO_REGISTERS_SIZE;
+}
+
+// calls func with the memory chip as its actual type. every type of memory chip is final, so none of the calls that func makes on it
+// are virtual, and the ones that are defined in its header (like reading cartridge RAM) can be inlined
+template <typename Function>
+static auto withMemoryChip(MemoryChip* chip, Function func)
+{
+    switch (chip->getType())
+    {
+        case MemoryChipType::MBC1: return func(static_cast<MBC1*>(chip));
+        case MemoryChipType::MBC2: return func(static_cast<MBC2*>(chip));
+        case MemoryChipType::MBC3: return func(static_cast<MBC3*>(chip));
+        case MemoryChipType::MBC5: return func(static_cast<MBC5*>(chip));
+        default:                   return func(static_cast<ROMOnly*>(chip));
+    }
+}
+
+// reads a single bye from memory that isn't mapped in the page table
 // depending on what is trying to be read from memory, we may have to 
 // do something particular (such as for input)
-Byte MMU::readByte(DoubleByte addr)
+Byte MMU::readByteSlow(DoubleByte addr)
 {
-    if (addr == JOYPAD_OFFSET)
+    // the bus is busy with the transfer
+    if (isBlockedByDMA(addr))
+        return 0xFF;
+
+    if (isIORegister(addr))
     {
-        if (!(ramMemory[addr - RAM_OFFSET] & 0x10)) // if the 4th bit is unset (looking for regular buttons)
-            return (ramMemory[addr - RAM_OFFSET] & 0xf0) | InputHandler::getDirectionKeysPressed();
+        IORegister& reg = mIORegisters[addr - IO_REGISTERS_OFFSET];
+        if (reg.read)
+            return reg.read(reg.owner, addr);
+    }
+    else if (addr <= 0x7FFF || (addr >= 0xA000 && addr <= 0xBFFF))
+        return withMemoryChip(memoryChip, [addr](auto chip) { return chip->readByte(addr); });
 
-        else if (!(ramMemory[addr - RAM_OFFSET] & 0x20)) // if action buttons are selected
-            return (ramMemory[addr - RAM_OFFSET] & 0xf0) | InputHandler::getActionKeysPressed();
+    return ramMemory[addr - RAM_OFFSET];
+}
 
-        return 0xFF;
+void MMU::mapROM()
+{
+    // both banks are contiguous, so each of their pages is just an offset from the start of the bank
+    const Byte* bank0 = withMemoryChip(memoryChip, [](auto chip) { return chip->getROMPointer(0x0000); });
+    const Byte* bank  = withMemoryChip(memoryChip, [](auto chip) { return chip->getROMPointer(0x4000); });
+
+    // most writes to ROM select the bank that is already there
+    if (mReadPages[0x00] == bank0 && mReadPages[0x40] == bank)
+        return;
+
+    for (int page = 0; page < 0x40; page++)
+    {
+        mReadPages[page]        = bank0 + (page << 8);
+        mReadPages[page + 0x40] = bank + (page << 8);
     }
-    else if (addr <= 0x7FFF || (addr >= 0xA000 && addr <= 0xBFFF))
-        return memoryChip->readByte(addr);
-    else
-        return ramMemory[addr - RAM_OFFSET];
+
+#ifdef HERMES_MEMORY_HOOKS
+    unmapWatchedPages();
+#endif
 }
 
 // reads a double byte from memory (little endian)
@@ -43,71 +100,54 @@ DoubleByte MMU::readDoubleByte(DoubleByte addr)
     return ((DoubleByte)(readByte(addr + 1)) << 8) | readByte(addr);
 }
 
-// writes a byte to memory
-void MMU::writeByte(DoubleByte addr, Byte val)
+// writes a byte to memory that can't just be written to directly (see writeByte)
+void MMU::writeByteSlow(DoubleByte addr, Byte val)
 {   
-    // writing to the address 0xFF46 means that the program wants to DMA into the OAM 
-    if (addr == OAM_DMA_OFFSET)
-    {
-        // increase ticks by 160?
-        // loop through all the bytes in the OAM
-        for (int byte = 0; byte < 0xA0; byte++)
-            writeByte(SPRITE_DATA_OFFSET + byte, readByte(((val << 8) + byte)));
-    }
+    if (isBlockedByDMA(addr))
+        return;
 
-    else if (addr == BG_PALETTE_OFFSET)
+    if (isIORegister(addr))
     {
-        Display::updateBackgroundPalette(val);
-        ramMemory[addr - RAM_OFFSET] = val;
+        IORegister& reg = mIORegisters[addr - IO_REGISTERS_OFFSET];
+        if (reg.write)
+        {
+            reg.write(reg.owner, addr, val);
+            return;
+        }
     }
 
-    else if (addr == S0_PALETTE_OFFSET)
+    // the scanlines that the PPU has put off rendering have to be rendered from what was there before
+    if (isReadByRenderer(addr))
     {
-        Display::updateSpritePalette0(val);
-        ramMemory[addr - RAM_OFFSET] = val;
+        mPPU->catchUp();
+        mVideoDirtyBits.mark(addr);
     }
 
-    else if (addr == S1_PALETTE_OFFSET)
+    // an interrupt that is both requested and enabled has to be serviced at the end of the instruction
+    if (addr == INTERRUPTS_ENABLED_OFFSET)
     {
-        Display::updateSpritePalette1(val);
         ramMemory[addr - RAM_OFFSET] = val;
+        updatePendingInterrupts();
     }
-
-    // writing to the DIV register causes it to reset to 0
-    else if (addr == DIV_REGISTER_OFFSET)
-    {
-        ramMemory[addr - RAM_OFFSET] = 0;
-        return;
-    }
-    else if (addr == TAC_REGISTER_OFFSET)
+    else if (addr <= 0x7FFF || (addr >= 0xA000 && addr <= 0xBFFF))
     {
-        *mCPUClockEnabled = val & 0b100;
+        withMemoryChip(memoryChip, [addr, val](auto chip) { chip->writeByte(addr, val); });
 
-        // the two bottom bits of the value will determine the speed at which the clock should update
-        // each clock speed denotes the number of ticks per update of the clock. for instance,
-        // if the clock updates at 4096Hz, that is the equivalent of 1 increment per 1024 ticks,
-        // as it would end up being 4096 increments in 4Mhz
-        switch (val & 0b11)
+        // writing to ROM is how the memory bank controllers switch banks
+        if (addr <= 0x7FFF)
         {
-            case 0b00: // cpu clock speed divided by 1024
-                *mCPUClockSpeed = 1024;
-                break;
-            case 0b01: // cpu clock speed divided by 16
-                *mCPUClockSpeed = 16;
-                break;
-            case 0b10: // cpu clock speed divided by 64
-                *mCPUClockSpeed = 64;
-                break;
-            case 0b11: // cpu clock speed divided by 256
-                *mCPUClockSpeed = 256;
-                break;
+            mapROM();
+            mBlockCache->onBankSwitch();
         }
-        ramMemory[addr - RAM_OFFSET] = val;
     }
-    else if (addr <= 0x7FFF || (addr >= 0xA000 && addr <= 0xBFFF))
-        memoryChip->writeByte(addr, val);
     else
+    {
         ramMemory[addr - RAM_OFFSET] = val;
+
+        // if code that has been cached was just overwritten, then it has to be decoded again
+        if (mBlockCache->containsCode(addr))
+            mBlockCache->invalidate(addr);
+    }
 }
 
 // writes a double byte to memory (little endian)
@@ -117,16 +157,211 @@ void MMU::writeDoubleByte(DoubleByte addr, DoubleByte val)
     writeByte(addr + 1, (val & 0xFF00) >> 8);
 }
 
+void MMU::setIOHandlers(DoubleByte addr, void* owner, IOReadHandler read, IOWriteHandler write)
+{
+    IORegister& reg = mIORegisters[addr - IO_REGISTERS_OFFSET];
+
+    reg.owner = owner;
+    reg.read  = read;
+    reg.write = write;
+}
+
+Byte MMU::readJoypad(void* mmu, DoubleByte addr)
+{
+    Byte joypad = ((MMU*)mmu)->ramMemory[addr - RAM_OFFSET];
+
+    if (!(joypad & 0x10)) // if the 4th bit is unset (looking for regular buttons)
+        return (joypad & 0xf0) | InputHandler::getDirectionKeysPressed();
+
+    else if (!(joypad & 0x20)) // if action buttons are selected
+        return (joypad & 0xf0) | InputHandler::getActionKeysPressed();
+
+    return 0xFF;
+}
+
+// writing to the address 0xFF46 means that the program wants to DMA into the OAM. the whole transfer is copied straight away, and the
+// CPU is kept off the bus until it would have finished
+void MMU::writeOAMDMA(void* mmu, DoubleByte addr, Byte val)
+{
+    MMU* self = (MMU*)mmu;
+
+    self->ramMemory[addr - RAM_OFFSET] = val;
+
+    // a transfer that is started during another one replaces it
+    if (self->mDMAActive)
+        self->finishDMA();
+
+    // the scanlines that the PPU has put off rendering have to be rendered from the old OAM
+    self->mPPU->catchUp();
+
+    DoubleByte source = val << 8;
+    Byte* oam = &self->ramMemory[SPRITE_DATA_OFFSET - RAM_OFFSET];
+
+    // the source is a single page, so if it can be read directly then so can all of the transfer
+    if (const Byte* sourcePointer = self->getReadPointer(source))
+        memcpy(oam, sourcePointer, OAM_DMA_SIZE);
+    else
+    {
+        for (int byte = 0; byte < OAM_DMA_SIZE; byte++)
+            oam[byte] = self->readByteSlow(source + byte);
+    }
+
+    self->mVideoDirtyBits.sprites = (1ULL << (OAM_DMA_SIZE / 4)) - 1;
+
+    for (int byte = 0; byte < OAM_DMA_SIZE; byte++)
+        if (self->mBlockCache->containsCode(SPRITE_DATA_OFFSET + byte))
+            self->mBlockCache->invalidate(SPRITE_DATA_OFFSET + byte);
+
+    self->mDMAActive = true;
+    self->mDMAFromVRAM = source >= 0x8000 && source <= 0x9FFF;
+
+    for (int page = 0; page < 0x100; page++)
+    {
+        if (self->isBlockedByDMA(page << 8))
+        {
+            self->mReadPages[page]  = NULL;
+            self->mWritePages[page] = NULL;
+        }
+    }
+
+    // the CPU can't fetch code from the pages that were just taken away from it either, so it has to look up the page that it fetches
+    // opcodes from again (and stop running the block it is in)
+    self->mBlockCache->onBankSwitch();
+
+    self->mScheduler->schedule(Event::DMA, self->mState->ticks + OAM_DMA_TICKS);
+}
+
+void MMU::finishDMA()
+{
+    mDMAActive = false;
+
+    mapRAM();
+    mapROM();
+
+    // the page that the CPU fetches opcodes from may have been one that the transfer was keeping it from
+    mBlockCache->onBankSwitch();
+
+    mScheduler->cancel(Event::DMA);
+}
+
+// an interrupt that is both requested and enabled has to be serviced at the end of the instruction
+void MMU::writeInterruptFlags(void* mmu, DoubleByte addr, Byte val)
+{
+    MMU* self = (MMU*)mmu;
+
+    self->ramMemory[addr - RAM_OFFSET] = val;
+    self->updatePendingInterrupts();
+}
+
+void MMU::updatePendingInterrupts()
+{
+    // there are only 5 interrupts, so the top 3 bits don't mean anything
+    mState->pendingInterrupts = ramMemory[INTERRUPT_OFFSET - RAM_OFFSET] & ramMemory[INTERRUPTS_ENABLED_OFFSET - RAM_OFFSET] & 0x1F;
+
+    // the CPU only has to check for interrupts when one of them is pending
+    if (mState->pendingInterrupts)
+        mScheduler->schedule(Event::INTERRUPTS, mState->ticks);
+}
+
+void MMU::mapRAM()
+{
+    // VRAM, work RAM (including its echo) and the OAM page can all be read directly, and the rest goes through readByteSlow. only work
+    // RAM can be written to directly though, as writes to VRAM and OAM have to let the PPU catch up first
+    for (int page = 0x80; page < 0x100; page++)
+    {
+        DoubleByte addr = page << 8;
+        bool isVRAM = addr >= 0x8000 && addr <= 0x9FFF;
+        bool isWorkRAM = addr >= 0xC000 && addr <= 0xFDFF;
+
+        mReadPages[page]  = (isVRAM || isWorkRAM || addr == SPRITE_DATA_OFFSET) ? &ramMemory[addr - RAM_OFFSET] : NULL;
+        mWritePages[page] = isWorkRAM ? &ramMemory[addr - RAM_OFFSET] : NULL;
+    }
+
+#ifdef HERMES_MEMORY_HOOKS
+    unmapWatchedPages();
+#endif
+}
+
+#ifdef HERMES_MEMORY_HOOKS
+Byte MMU::readByteHooked(DoubleByte addr)
+{
+    Byte val = readByteSlow(addr);
+
+    if (mHooks.isWatched(HookType::READ, addr))
+        mHooks.run(HookType::READ, addr, val);
+
+    return val;
+}
+
+void MMU::writeByteHooked(DoubleByte addr, Byte val)
+{
+    writeByteSlow(addr, val);
+
+    if (mHooks.isWatched(HookType::WRITE, addr))
+        mHooks.run(HookType::WRITE, addr, val);
+}
+
+void MMU::unmapWatchedPages()
+{
+    for (int page = 0; page < 0x100; page++)
+    {
+        if (mHooks.isPageWatched(HookType::READ, page))
+            mReadPages[page] = NULL;
+
+        if (mHooks.isPageWatched(HookType::WRITE, page))
+            mWritePages[page] = NULL;
+    }
+}
+
+void MMU::addHook(HookType type, DoubleByte first, DoubleByte last, MemoryHook callback, void* user)
+{
+    mHooks.add(type, first, last, callback, user);
+    unmapWatchedPages();
+
+    // code from a page that is being watched for execution or reading can't be cached anymore. either way, the CPU has to look up the
+    // page that it fetches opcodes from again
+    if (type != HookType::WRITE)
+        mBlockCache->clear();
+    else
+        mBlockCache->onBankSwitch();
+}
+#endif
+
 // initialize some default values for the memory management unit
-void MMU::init(uint64_t* ticks, DoubleByte* cpuClockSpeed, bool* cpuClockEnabled)
+void MMU::init(CoreState* state, BlockCache* blockCache, Scheduler* scheduler, PPU* ppu, Timer* timer)
 {
-    mTicks = ticks;
-    mCPUClockSpeed = cpuClockSpeed;
-    mCPUClockEnabled = cpuClockEnabled;
+    mState = state;
+    mBlockCache = blockCache;
+    mScheduler = scheduler;
+    mPPU = ppu;
+    mTimer = timer;
 
     // set all the bytes in the RAM memory to 0 by default (as this is what the original gameboy did)
     memset(ramMemory, 0, RAM_MEMORY_SIZE);
 
+    // the ROM is mapped once there is a memory chip
+    memset(mReadPages, 0, sizeof(mReadPages));
+    memset(mWritePages, 0, sizeof(mWritePages));
+    mapRAM();
+
+    mDMAActive = false;
+    mDMAFromVRAM = false;
+
+    // nothing has been drawn from VRAM yet, so all of it counts as having changed
+    mVideoDirtyBits.markAll();
+
+    // the rest of the i/o registers are set up by the components that they belong to, which have to be able to handle the starting
+    // values being written to them
+    for (int reg = 0; reg < IO_REGISTERS_SIZE; reg++)
+        setIOHandlers(IO_REGISTERS_OFFSET + reg, NULL, NULL, NULL);
+
+    setIOHandlers(JOYPAD_OFFSET, this, readJoypad, NULL);
+    setIOHandlers(OAM_DMA_OFFSET, this, NULL, writeOAMDMA);
+    setIOHandlers(INTERRUPT_OFFSET, this, NULL, writeInterruptFlags);
+
+    mTimer->setIOHandlers(this);
+    mPPU->setIOHandlers(this, scheduler, &state->ticks);
+
     // initialize the values in the RAM. taken from the pandocs at https://gbdev.io/pandocs/Power_Up_Sequence.html
     writeByte(0xFF00, 0xCF);
     writeByte(0xFF01, 0x0);
@@ -162,7 +397,7 @@ void MMU::init(uint64_t* ticks, DoubleByte* cpuClockSpeed, bool* cpuClockEnabled
     writeByte(0xFF43, 0x0);
     writeByte(0xFF44, 0x91);
     writeByte(0xFF45, 0x0);
-    writeByte(0xFF46, 0xFF);
+    ramMemory[OAM_DMA_OFFSET - RAM_OFFSET] = 0xFF; // only the register's value, as no transfer is going on
     writeByte(0xFF47, 0xFC);
     writeByte(0xFF4A, 0x0);
     writeByte(0xFF4B, 0x0);
@@ -180,15 +415,14 @@ void MMU::init(uint64_t* ticks, DoubleByte* cpuClockSpeed, bool* cpuClockEnabled
     writeByte(0xFF6B, 0xFF);
     writeByte(0xFF70, 0xFF);
     writeByte(0xFFFF, 0x0);
-
-    // the DIV register offset is set manually like so, because using the writeByte function will attempt
-    // to read rom memory, which may or not have been initialized yet. furthrmore, it would actually
-    // set the value to 0! 
-    ramMemory[DIV_REGISTER_OFFSET - RAM_OFFSET] = 0x18;
 }
 
 void MMU::saveRAMToFile(std::ofstream& file)
 {
+    // the DIV and TIMA registers aren't kept up to date in memory, so they have to be put there before it is saved
+    ramMemory[DIV_REGISTER_OFFSET - RAM_OFFSET]  = mTimer->readDiv();
+    ramMemory[TIMA_REGISTER_OFFSET - RAM_OFFSET] = mTimer->readTima();
+
     file.write((char*)ramMemory, RAM_MEMORY_SIZE);
     memoryChip->saveRAMToFile(file);
 }
@@ -201,9 +435,28 @@ void MMU::setRAMFromFile(std::ifstream& file)
     file.seekg(SAVE_FILE_RAM_OFFSET_START, file.beg);
 
     file.read(dataBuffer, RAM_MEMORY_SIZE);
+
+    // the scanlines that were reached before loading are rendered from what was there before
+    mPPU->catchUp();
+
+    // the save file doesn't keep track of a transfer that was going on
+    if (mDMAActive)
+        finishDMA();
     
     for (int byte = 0; byte < RAM_MEMORY_SIZE; byte++)
         ramMemory[byte] = Byte(dataBuffer[byte]);
 
+    mVideoDirtyBits.markAll();
+
     memoryChip->setRAMFromFile(file);
+    mapROM();
+
+    // all of the RAM (and possibly the ROM bank) just changed, so none of the code cached from RAM can be trusted anymore
+    mBlockCache->invalidateRAM();
+
+    // the same goes for when the PPU, timer and interrupts have to be updated next
+    mScheduler->schedule(Event::PPU, mState->ticks);
+    mTimer->setFromMemory(ramMemory[DIV_REGISTER_OFFSET - RAM_OFFSET], ramMemory[TIMA_REGISTER_OFFSET - RAM_OFFSET],
+                          ramMemory[TAC_REGISTER_OFFSET - RAM_OFFSET]);
+    updatePendingInterrupts();
 }
\ No newline at end of file
@@ -3,11 +3,78 @@
 #include <cstdint>
 #include <fstream>
 
+#include "BlockCache.h"
 #include "Constants.h"
+#include "CoreState.h"
 #include "MemoryChips/MemoryChip.h"
+#include "MemoryHooks.h"
+#include "Scheduler.h"
+#include "Timer.h"
 
 const DoubleByte RAM_MEMORY_SIZE = 0x8000;
 
+// the i/o registers take up the first half of the page at 0xFF00
+const DoubleByte IO_REGISTERS_OFFSET = 0xFF00;
+const DoubleByte IO_REGISTERS_SIZE   = 0x80;
+
+// handlers for reading and writing an i/o register, which are given back the owner that they were registered with
+typedef Byte (*IOReadHandler)(void* owner, DoubleByte addr);
+typedef void (*IOWriteHandler)(void* owner, DoubleByte addr, Byte val);
+
+class PPU;
+
+/*
+    which parts of VRAM and OAM have been written to since the bits were last cleared: one bit per tile of tile data (16 bytes from
+    0x8000-0x97FF), per row of a tile map (32 bytes from 0x9800-0x9FFF) and per sprite in OAM (4 bytes from 0xFE00-0xFE9F). they are
+    packed into words, so that checking whether anything changed at all only takes a handful of ORs
+*/
+struct VideoDirtyBits
+{
+    static const int TILE_COUNT = 384;
+
+    uint64_t tiles[TILE_COUNT / 64];
+    uint64_t tileMapRows; // the 32 rows of the tile map at 0x9800, followed by the 32 rows of the one at 0x9C00
+    uint64_t sprites;
+
+    bool isTileDirty(int tile)       { return tiles[tile / 64] & (1ULL << (tile % 64)); }
+    bool isTileMapRowDirty(int row)  { return tileMapRows & (1ULL << row); }
+    bool isSpriteDirty(int sprite)   { return sprites & (1ULL << sprite); }
+
+    bool isAnythingDirty()
+    {
+        return tiles[0] | tiles[1] | tiles[2] | tiles[3] | tiles[4] | tiles[5] | tileMapRows | sprites;
+    }
+
+    // marks whatever the byte at addr (which has to be in VRAM or OAM) is a part of
+    void mark(DoubleByte addr)
+    {
+        if (addr < 0x9800)
+            tiles[(addr - 0x8000) / 16 / 64] |= 1ULL << ((addr - 0x8000) / 16 % 64);
+        else if (addr <= 0x9FFF)
+            tileMapRows |= 1ULL << ((addr - 0x9800) / 32);
+        else
+            sprites |= 1ULL << ((addr - 0xFE00) / 4);
+    }
+
+    void markAll()
+    {
+        for (int word = 0; word < TILE_COUNT / 64; word++)
+            tiles[word] = ~0ULL;
+
+        tileMapRows = ~0ULL;
+        sprites     = (1ULL << 40) - 1;
+    }
+
+    void clear()
+    {
+        for (int word = 0; word < TILE_COUNT / 64; word++)
+            tiles[word] = 0;
+
+        tileMapRows = 0;
+        sprites     = 0;
+    }
+};
+
 /* 
     the memory management unit (MMU) struct is responsible for handling all the memory of the cartridge
     it uses a union so that we can reference the memory using different names for convienience
@@ -15,26 +82,202 @@ const DoubleByte RAM_MEMORY_SIZE = 0x8000;
 struct MMU
 {
 private:
-    uint64_t* mTicks;
-    DoubleByte* mCPUClockSpeed;
-    bool* mCPUClockEnabled;
+    // the CPU's core state, for its tick count and the pending interrupts
+    CoreState* mState;
+
+    // needs to know about writes to code that it has cached, as well as ROM bank switches
+    BlockCache* mBlockCache;
+
+    // writing to the LCDC, IF and IE registers changes when the PPU and interrupts have to be updated
+    Scheduler* mScheduler;
+
+    // has to render the scanlines that it put off before anything they are rendered from changes
+    PPU* mPPU;
+
+    // handles the DIV, TIMA and TAC registers
+    Timer* mTimer;
+
+    // the handlers for each of the i/o registers, which the components that the registers belong to set up for themselves. a NULL
+    // handler means that the register is read or written to like any other memory
+    struct IORegister
+    {
+        void* owner;
+        IOReadHandler read;
+        IOWriteHandler write;
+    };
+
+    IORegister mIORegisters[IO_REGISTERS_SIZE];
+
+    // what has been written to in VRAM and OAM, since whoever is keeping track of it last cleared it
+    VideoDirtyBits mVideoDirtyBits;
+
+    // while an OAM DMA transfer is going on, the CPU can't access OAM or the bus that the transfer is reading from (the one VRAM is on, or
+    // the external one that the cartridge and work RAM are on), but can still access the other bus and the page at 0xFF00 (the i/o
+    // registers and high RAM). the blocked pages are taken out of the page tables for its duration, so that only readByteSlow and
+    // writeByteSlow have to check for it
+    bool mDMAActive;
+    bool mDMAFromVRAM;
+
+    // points the page tables at VRAM, work RAM and OAM
+    void mapRAM();
+
+#ifdef HERMES_MEMORY_HOOKS
+    MemoryHooks mHooks;
+
+    // the pages that hooks are watching are kept out of the page tables, so that accessing them ends up in these
+    Byte readByteHooked(DoubleByte addr);
+    void writeByteHooked(DoubleByte addr, Byte val);
+
+    void unmapWatchedPages();
+#endif
+
+    // the handlers for the registers that the MMU looks after itself
+    static Byte readJoypad(void* mmu, DoubleByte addr);
+    static void writeOAMDMA(void* mmu, DoubleByte addr, Byte val);
+    static void writeInterruptFlags(void* mmu, DoubleByte addr, Byte val);
+
+    // keeps the pending interrupts in the core state up to date, whenever the IF or IE register is written to
+    void updatePendingInterrupts();
+
+    /*
+        the memory map, split into 256 byte pages. each entry points to the start of a page that can be read (or written to) directly,
+        or is NULL if accessing that page has to go through readByteSlow (or writeByteSlow), i.e. for cartridge RAM, the i/o registers and
+        anything else that does more than just an access. the ROM pages are pointed at the selected bank, and are updated whenever it
+        could have changed (see mapROM)
+    */
+    const Byte* mReadPages[0x100];
+    Byte* mWritePages[0x100];
+
+    Byte readByteSlow(DoubleByte addr);
+    void writeByteSlow(DoubleByte addr, Byte val);
+
+    // returns true if both bytes at addr and addr + 1 are in work RAM (including its echo) or high RAM, where reading and writing
+    // doesn't have to do anything besides the access itself
+    static bool isPlainRAM(DoubleByte addr) { return (addr >= 0xC000 && addr < 0xFDFF) || (addr >= 0xFF80 && addr < 0xFFFE); }
 
 public:
-    Byte* romMemory;
+    // the ROM is mapped read only, so it can't be written to
+    const Byte* romMemory;
 
     // this includes vram, hram, i/o registers, etc. just any memory that is not related to the ROM memory 
     Byte ramMemory[RAM_MEMORY_SIZE];
 
     MemoryChip* memoryChip;
 
-    void init(uint64_t* ticks, DoubleByte* cpuClockSpeed, bool* cpuClockEnabled);
+    void init(CoreState* state, BlockCache* blockCache, Scheduler* scheduler, PPU* ppu, Timer* timer);
+
+    // returns what has been written to in VRAM and OAM since clearVideoDirtyBits was last called. this is meant to be checked and
+    // cleared once per frame, by whatever wants to skip the parts that didn't change (rendering, debuggers, save state deltas, etc.)
+    VideoDirtyBits& getVideoDirtyBits() { return mVideoDirtyBits; }
+    void clearVideoDirtyBits()          { mVideoDirtyBits.clear(); }
+
+    // called once an OAM DMA transfer is over, to give the CPU access to the rest of memory again
+    void finishDMA();
+
+    // makes the i/o register at addr go through the given handlers, either of which can be NULL
+    void setIOHandlers(DoubleByte addr, void* owner, IOReadHandler read, IOWriteHandler write);
+
+    // points the ROM pages at the banks that the memory chip has selected. has to be called once the memory chip is set
+    void mapROM();
+
+    Byte readByte(DoubleByte addr)
+    {
+        if (const Byte* page = mReadPages[addr >> 8])
+            return page[addr & 0xFF];
+
+#ifdef HERMES_MEMORY_HOOKS
+        return readByteHooked(addr);
+#else
+        return readByteSlow(addr);
+#endif
+    }
+
+    // returns a pointer that can be used to read the byte at addr directly (and the rest of its 256 byte page), or NULL if reading
+    // that part of memory has to go through readByte. pointers into ROM are only valid until the next bank switch
+    const Byte* getReadPointer(DoubleByte addr)
+    {
+        const Byte* page = mReadPages[addr >> 8];
+        return page ? page + (addr & 0xFF) : NULL;
+    }
 
-    Byte readByte(DoubleByte addr);
     DoubleByte readDoubleByte(DoubleByte addr);
 
-    void writeByte(DoubleByte addr, Byte val);
+    void writeByte(DoubleByte addr, Byte val)
+    {
+        // code that was cached from there has to be thrown away, which writeByteSlow takes care of
+        Byte* page = mWritePages[addr >> 8];
+        if (page && !mBlockCache->containsCode(addr))
+            page[addr & 0xFF] = val;
+        else
+#ifdef HERMES_MEMORY_HOOKS
+            writeByteHooked(addr, val);
+#else
+            writeByteSlow(addr, val);
+#endif
+    }
+
     void writeDoubleByte(DoubleByte addr, DoubleByte val);
 
+    // reads and writes a value on the stack (little endian). the stack is nearly always in work RAM or high RAM, so that is read and
+    // written to directly, and anywhere else goes through readDoubleByte and writeDoubleByte
+    DoubleByte readStack(DoubleByte addr)
+    {
+#ifdef HERMES_MEMORY_HOOKS
+        if (mHooks.isWatched(HookType::READ, addr) || mHooks.isWatched(HookType::READ, addr + 1))
+            return readDoubleByte(addr);
+#endif
+
+        if (isPlainRAM(addr) && !mDMAActive)
+            return ramMemory[addr - RAM_OFFSET] | (DoubleByte(ramMemory[addr + 1 - RAM_OFFSET]) << 8);
+
+        return readDoubleByte(addr);
+    }
+
+    void writeStack(DoubleByte addr, DoubleByte val)
+    {
+#ifdef HERMES_MEMORY_HOOKS
+        if (mHooks.isWatched(HookType::WRITE, addr) || mHooks.isWatched(HookType::WRITE, addr + 1))
+        {
+            writeDoubleByte(addr, val);
+            return;
+        }
+#endif
+
+        // code that was cached from there has to be thrown away, which writeByte takes care of
+        if (isPlainRAM(addr) && !mDMAActive && !mBlockCache->containsCode(addr) && !mBlockCache->containsCode(addr + 1))
+        {
+            ramMemory[addr - RAM_OFFSET]     = val & 0xFF;
+            ramMemory[addr + 1 - RAM_OFFSET] = val >> 8;
+        }
+        else
+            writeDoubleByte(addr, val);
+    }
+
+#ifdef HERMES_MEMORY_HOOKS
+    // hooks can't be added from inside of a hook (adding an execute or read hook throws away every cached block, including the one that
+    // is running). opcodes and operands that are fetched from a page that a read hook is watching are reported to it as well, as that
+    // code is never cached
+    void addHook(HookType type, DoubleByte first, DoubleByte last, MemoryHook callback, void* user);
+
+    MemoryHooks& getHooks() { return mHooks; }
+#endif
+
+    // returns true if an OAM DMA transfer is keeping the CPU from accessing addr
+    bool isBlockedByDMA(DoubleByte addr)
+    {
+        if (!mDMAActive || addr >= IO_REGISTERS_OFFSET)
+            return false;
+
+        // OAM (and the unusable memory after it) is being written to by the transfer, whichever bus it is reading from
+        if (addr >= 0xFE00)
+            return true;
+
+        return (addr >= 0x8000 && addr <= 0x9FFF) == mDMAFromVRAM;
+    }
+
+    // returns IE & IF, without having to read both of them
+    Byte getPendingInterrupts() { return mState->pendingInterrupts; }
+
     void saveRAMToFile(std::ofstream& file);
     void setRAMFromFile(std::ifstream& file);
 };
\ No newline at end of file
@@ -2,13 +2,14 @@
 
 #include <cstring>
 
-MBC::MBC(Byte* memory, DoubleByte numOfRomBanks, DoubleByte numOfRamBanks)
-    : MemoryChip(memory)
+MBC::MBC(const Byte* memory, MemoryChipType type, DoubleByte numOfRomBanks, DoubleByte numOfRamBanks)
+    : MemoryChip(memory, type)
 {
     mSelectedROMBank = 1;
     mSelectedRAMBank = 0;
     mNumOfRomBanks = numOfRomBanks;
     mNumOfRamBanks = numOfRamBanks;
+    mROMBankMask = numOfRomBanks - 1;
 
     mRAMEnabled = false;
 
@@ -21,22 +22,6 @@ MBC::MBC(Byte* memory, DoubleByte numOfRomBanks, DoubleByte numOfRamBanks)
     }
 }
 
-Byte MBC::readByte(DoubleByte addr)
-{
-    // if trying to read a ROM memory bank that is NOT bank 0:
-    if (addr >= 0x4000 && addr <= 0x7FFF)
-        return mROMMemory[(addr - 0x4000) + ROM_BANK_SIZE * mSelectedROMBank];
-    else if (addr >= 0xA000 && addr <= 0xBFFF)
-    {
-        if (mRAMEnabled)
-            return mRAMBanks[mSelectedRAMBank][addr - 0xA000];
-        else
-            return 0xFF;
-    }
-
-    return mROMMemory[addr];
-}
-
 // from addresses 0x800D-0x1000F (the original 0x8000 RAM in all games + 0xB bytes in registers and 0x1 byte in saving the state of the master interrupt),
 // the RAM from the memory controller's RAM banks will be stored
 // the memory stored contains all of the memory banks, as well as the state of the ram/rom at the time of saving
@@ -69,6 +54,8 @@ void MBC::setRAMFromFile(std::ifstream& file)
     if (mSelectedROMBank == 0)
         mSelectedROMBank = 1;
 
+    mSelectedROMBank &= mROMBankMask;
+
     char* dataBuffer = new char[RAM_BANK_SIZE * mNumOfRamBanks];
 
     file.read(dataBuffer, RAM_BANK_SIZE * mNumOfRamBanks);
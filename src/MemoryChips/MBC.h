@@ -16,16 +16,47 @@ protected:
     DoubleByte mNumOfRomBanks;
     DoubleByte mNumOfRamBanks;
 
+    // the cartridge only has as many address lines as it needs for its banks, so the selected bank is always masked with this (the
+    // number of banks minus 1) and wraps around past the last bank instead of pointing past the end of the ROM
+    DoubleByte mROMBankMask;
+
     bool mRAMEnabled;
     Byte** mRAMBanks;
 
 public:
-    MBC(Byte* memory, DoubleByte numOfRomBanks, DoubleByte numOfRamBanks);
+    MBC(const Byte* memory, MemoryChipType type, DoubleByte numOfRomBanks, DoubleByte numOfRamBanks);
+
+    // reading is defined here so that it can be inlined wherever the type of memory bank controller is known
+    virtual Byte readByte(DoubleByte addr)
+    {
+        // if trying to read a ROM memory bank that is NOT bank 0:
+        if (addr >= 0x4000 && addr <= 0x7FFF)
+            return mROMMemory[(addr - 0x4000) + ROM_BANK_SIZE * mSelectedROMBank];
+        else if (addr >= 0xA000 && addr <= 0xBFFF)
+        {
+            if (mRAMEnabled)
+                return mRAMBanks[mSelectedRAMBank][addr - 0xA000];
+            else
+                return 0xFF;
+        }
+
+        return mROMMemory[addr];
+    }
 
-    virtual Byte readByte(DoubleByte addr);
     virtual void writeByte(DoubleByte addr, Byte val) = 0;
 
     // for save file saving/loading
     virtual void saveRAMToFile(std::ofstream& file);
     virtual void setRAMFromFile(std::ifstream& file);
+
+    virtual DoubleByte getSelectedROMBank() { return mSelectedROMBank; }
+
+    // the same mapping as readByte uses for ROM
+    virtual const Byte* getROMPointer(DoubleByte addr)
+    {
+        if (addr >= 0x4000)
+            return &mROMMemory[(addr - 0x4000) + ROM_BANK_SIZE * mSelectedROMBank];
+
+        return &mROMMemory[addr];
+    }
 };
\ No newline at end of file
@@ -3,8 +3,8 @@
 // the number of ROM banks needed (64) for the two higher bits to be able to be set (if in ROM mode and not RAM mode)
 const Byte ROM_SIZE_FOR_HIGHER_BITS = 0x40;
 
-MBC1::MBC1(Byte* memory, Byte numOfRomBanks, Byte numOfRamBanks) 
-    : MBC(memory, numOfRomBanks, numOfRamBanks)
+MBC1::MBC1(const Byte* memory, DoubleByte numOfRomBanks, Byte numOfRamBanks) 
+    : MBC(memory, MemoryChipType::MBC1, numOfRomBanks, numOfRamBanks)
 { 
     mUpperRomBankBits = 0; 
     mMemoryMode = MEMORY_MODE::ROM_MODE;
@@ -28,6 +28,8 @@ void MBC1::writeByte(DoubleByte addr, Byte val)
         // never let the ROM bank be 0 (the first 0x4000 bytes already belong to rom bank 0)
         if (mSelectedROMBank == 0 || mSelectedROMBank == 0x20 || mSelectedROMBank == 0x40 || mSelectedROMBank == 0x60)
             mSelectedROMBank++;
+
+        mSelectedROMBank &= mROMBankMask;
     }
     else if (addr >= 0x4000 && addr <= 0x5FFF)
     {
@@ -41,6 +43,8 @@ void MBC1::writeByte(DoubleByte addr, Byte val)
             // never let the ROM bank be 0 (the first 0x4000 bytes already belong to rom bank 0)
             if (mSelectedROMBank == 0 || mSelectedROMBank == 0x20 || mSelectedROMBank == 0x40 || mSelectedROMBank == 0x60)
                 mSelectedROMBank++;
+
+            mSelectedROMBank &= mROMBankMask;
         }
     }
     else if (addr >= 0x6000 && addr <= 0x7FFF) // this address is written to when switching the rom/ram mode
@@ -104,6 +108,8 @@ void MBC1::setRAMFromFile(std::ifstream& file)
     if (mSelectedROMBank == 0 || mSelectedROMBank == 0x20 || mSelectedROMBank == 0x40 || mSelectedROMBank == 0x60)
         mSelectedROMBank++;
 
+    mSelectedROMBank &= mROMBankMask;
+
     char* dataBuffer = new char[RAM_BANK_SIZE * mNumOfRamBanks];
 
     file.read(dataBuffer, RAM_BANK_SIZE * mNumOfRamBanks);
@@ -2,7 +2,7 @@
 
 #include "MBC.h"
 
-class MBC1 : public MBC
+class MBC1 final : public MBC
 {
 private:
     /*
@@ -19,7 +19,7 @@ private:
     Byte mUpperRomBankBits;
 
 public:
-    MBC1(Byte* memory, Byte numOfRomBanks, Byte numOfRamBanks);
+    MBC1(const Byte* memory, DoubleByte numOfRomBanks, Byte numOfRamBanks);
 
     virtual void writeByte(DoubleByte addr, Byte val);
     virtual void saveRAMToFile(std::ofstream& file);
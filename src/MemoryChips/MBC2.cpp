@@ -13,28 +13,10 @@ void MBC2::writeByte(DoubleByte addr, Byte val)
 
             if (mSelectedROMBank == 0)
                 mSelectedROMBank++;
+
+            mSelectedROMBank &= mROMBankMask;
         }
         else // if the 8th bit is clear then we are enabling/disabling RAM
             mRAMEnabled = (val & 0xF) == 0xA;
     }
-}
-
-Byte MBC2::readByte(DoubleByte addr)
-{
-    // if trying to read a ROM memory bank that is NOT bank 0:
-    if (addr >= 0x4000 && addr <= 0x7FFF)
-        return mROMMemory[(addr - 0x4000) + ROM_BANK_SIZE * mSelectedROMBank];
-    else if (addr >= 0xA000 && addr <= 0xBFFF)
-    {
-        if (mRAMEnabled)
-            // the selected RAM bank is always 0, and only the first 512 bytes are used
-            // the RAM memory "echoes" (repeats) all the way until 0xBFFF, so using 
-            // modulu is appropriate for our case, as any value exceeding 0xA1FF
-            // will simply loop back around
-            return mRAMBanks[0][addr % 0x1FF];
-        else
-            return 0xFF;
-    }
-
-    return mROMMemory[addr];
 }
\ No newline at end of file
@@ -13,6 +13,8 @@ void MBC3::writeByte(DoubleByte addr, Byte val)
         // never let the ROM bank be 0 (the first 0x4000 bytes already belong to rom bank 0)
         if (mSelectedROMBank == 0)
             mSelectedROMBank = 1;
+
+        mSelectedROMBank &= mROMBankMask;
     }
     else if (addr >= 0x4000 && addr <= 0x5FFF)
     {
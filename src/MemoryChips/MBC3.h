@@ -2,10 +2,10 @@
 
 #include "MBC.h"
 
-class MBC3 : public MBC
+class MBC3 final : public MBC
 {
 public:
-    MBC3(Byte* memory, Byte numOfRomBanks, Byte numOfRamBanks) : MBC(memory, numOfRomBanks, numOfRamBanks) {}
+    MBC3(const Byte* memory, DoubleByte numOfRomBanks, Byte numOfRamBanks) : MBC(memory, MemoryChipType::MBC3, numOfRomBanks, numOfRamBanks) {}
 
     virtual void writeByte(DoubleByte addr, Byte val);
 };
\ No newline at end of file
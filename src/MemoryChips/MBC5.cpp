@@ -7,10 +7,10 @@ void MBC5::writeByte(DoubleByte addr, Byte val)
         mRAMEnabled = (val & 0xF) == 0xA;
     else if (addr >= 0x2000 && addr <= 0x2FFF)
         // set the 8 least significant bits of the selected ROM bank
-        mSelectedROMBank = (mSelectedROMBank & 0xFF00) | val;
+        mSelectedROMBank = ((mSelectedROMBank & 0xFF00) | val) & mROMBankMask;
     else if (addr >= 0x3000 && addr <= 0x3FFF)
-        // use all 8 bits of the value passed in 
-        mSelectedROMBank = (mSelectedRAMBank & 0xFF) | ((val & 1) << 8);
+        // the first bit of the value is the 9th bit of the selected ROM bank
+        mSelectedROMBank = ((mSelectedROMBank & 0xFF) | ((val & 1) << 8)) & mROMBankMask;
     else if (addr >= 0x4000 && addr <= 0x5FFF)
         mSelectedRAMBank = val & 0xF;
     else if (addr >= 0xA000 && addr <= 0xBFFF)
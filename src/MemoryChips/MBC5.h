@@ -2,10 +2,10 @@
 
 #include "MBC.h"
 
-class MBC5 : public MBC
+class MBC5 final : public MBC
 {
 public:
-    MBC5(Byte* memory, Byte numOfRomBanks, Byte numOfRamBanks) : MBC(memory, numOfRomBanks, numOfRamBanks) {}
+    MBC5(const Byte* memory, DoubleByte numOfRomBanks, Byte numOfRamBanks) : MBC(memory, MemoryChipType::MBC5, numOfRomBanks, numOfRamBanks) {}
 
     virtual void writeByte(DoubleByte addr, Byte val);
 };
\ No newline at end of file
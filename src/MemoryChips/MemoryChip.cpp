@@ -1,6 +1,7 @@
 #include "MemoryChip.h"
 
-MemoryChip::MemoryChip(Byte* memory)
+MemoryChip::MemoryChip(const Byte* memory, MemoryChipType type)
+    : mType(type)
 {
     mROMMemory = memory;
 }
\ No newline at end of file
@@ -6,6 +6,16 @@
 
 const DoubleByte RAM_BANK_SIZE = 0x2000;
 
+// every type of memory chip. each of them is final, so knowing the type is enough to call into it without going through a virtual call
+enum class MemoryChipType
+{
+    ROM_ONLY,
+    MBC1,
+    MBC2,
+    MBC3,
+    MBC5,
+};
+
 class MemoryChip
 {
 protected:
@@ -22,13 +32,23 @@ protected:
     const DoubleByte S0_PALETTE_OFFSET = 0xFF48;
     const DoubleByte S1_PALETTE_OFFSET = 0xFF49;
 
-    Byte* mROMMemory;
+    const Byte* mROMMemory;
+
+    const MemoryChipType mType;
 
 public:
-    MemoryChip(Byte* romMemory);
+    MemoryChip(const Byte* romMemory, MemoryChipType type);
+
+    MemoryChipType getType() { return mType; }
 
     virtual Byte readByte(DoubleByte addr)            = 0;
     virtual void writeByte(DoubleByte addr, Byte val) = 0;
     virtual void saveRAMToFile(std::ofstream& file)   = 0;
     virtual void setRAMFromFile(std::ifstream& file)  = 0;
+
+    // the ROM bank currently mapped to 0x4000-0x7FFF
+    virtual DoubleByte getSelectedROMBank()           = 0;
+
+    // returns a pointer to the byte of ROM (0x0000-0x7FFF) currently mapped to addr. it stays valid until the next bank switch
+    virtual const Byte* getROMPointer(DoubleByte addr) = 0;
 };
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "ROMOnly.h"
 
-ROMOnly::ROMOnly(Byte* romMemory, Byte numOfRamBanks)
- : MemoryChip(romMemory)
+ROMOnly::ROMOnly(const Byte* romMemory, Byte numOfRamBanks)
+ : MemoryChip(romMemory, MemoryChipType::ROM_ONLY)
 { 
     mSupportsRam = numOfRamBanks;
 
@@ -9,11 +9,6 @@ ROMOnly::ROMOnly(Byte* romMemory, Byte numOfRamBanks)
         mRamMemory = new Byte[RAM_BANK_SIZE];
 }
 
-Byte ROMOnly::readByte(DoubleByte addr)
-{
-    return mROMMemory[addr];
-}
-
 void ROMOnly::writeByte(DoubleByte addr, Byte val)
 {   
     // unless we are allowing ROM bank switching, do not allow the actual ROM (read only memory) to be changed!
@@ -24,9 +19,5 @@ void ROMOnly::writeByte(DoubleByte addr, Byte val)
     {
         if (mSupportsRam)
             mRamMemory[addr - 0xA000] = val;
-
-        return;
     }
-    else
-        mROMMemory[addr] = val;
 }
\ No newline at end of file
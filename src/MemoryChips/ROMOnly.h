@@ -1,18 +1,30 @@
+#pragma once
+
 #include "MemoryChip.h"
 
-class ROMOnly : public MemoryChip
+class ROMOnly final : public MemoryChip
 {
 private:
     bool mSupportsRam;
     Byte* mRamMemory;
 
 public:
-    ROMOnly(Byte* romMemory, Byte numOfRamBanks);
+    ROMOnly(const Byte* romMemory, Byte numOfRamBanks);
+
+    virtual Byte readByte(DoubleByte addr)
+    {
+        if (addr >= 0xA000 && addr <= 0xBFFF)
+            return mSupportsRam ? mRamMemory[addr - 0xA000] : 0xFF;
 
-    virtual Byte readByte(DoubleByte addr);
+        return mROMMemory[addr];
+    }
     virtual void writeByte(DoubleByte addr, Byte val);
 
     // ROM only uses no memory banking
     virtual void saveRAMToFile(std::ofstream& file)  {}
     virtual void setRAMFromFile(std::ifstream& file) {};
+
+    // without any banking, 0x4000-0x7FFF always holds bank 1
+    virtual DoubleByte getSelectedROMBank() { return 1; }
+    virtual const Byte* getROMPointer(DoubleByte addr) { return &mROMMemory[addr]; }
 };
\ No newline at end of file
@@ -0,0 +1,28 @@
+#ifdef HERMES_MEMORY_HOOKS
+
+#include <cstring>
+
+#include "MemoryHooks.h"
+
+MemoryHooks::MemoryHooks()
+{
+    memset(mWatchedPages, 0, sizeof(mWatchedPages));
+}
+
+void MemoryHooks::add(HookType type, DoubleByte first, DoubleByte last, MemoryHook callback, void* user)
+{
+    mHooks.push_back({ type, first, last, callback, user });
+
+    for (int page = first >> 8; page <= last >> 8; page++)
+        mWatchedPages[(int)type][page / 64] |= 1ULL << (page % 64);
+}
+
+// only accesses to watched pages get this far, so the few hooks that there are can just be checked one by one
+void MemoryHooks::run(HookType type, DoubleByte addr, Byte val)
+{
+    for (const Hook& hook : mHooks)
+        if (hook.type == type && addr >= hook.first && addr <= hook.last)
+            hook.callback(hook.user, addr, val);
+}
+
+#endif
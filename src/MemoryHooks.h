@@ -0,0 +1,61 @@
+#pragma once
+
+#ifdef HERMES_MEMORY_HOOKS
+
+#include <cstdint>
+#include <vector>
+
+#include "Constants.h"
+
+enum class HookType
+{
+    READ,
+    WRITE,
+    EXECUTE,
+};
+
+// a hook is given back the pointer it was added with, the address that was accessed, and the byte that was read, written or is about
+// to be executed (the opcode)
+typedef void (*MemoryHook)(void* user, DoubleByte addr, Byte val);
+
+/*
+    read, write and execute hooks, for cheats, debuggers and pulling values out of a game's memory. they are only built with
+    HERMES_MEMORY_HOOKS, and even then only the 256 byte pages that a hook is watching cost anything: the MMU takes those pages out of its
+    page tables (so that accessing them goes through its slow path, which is where hooks are ran), and the CPU never caches code from a
+    page that an execute or read hook is watching (so that it has to fetch and run it one opcode at a time)
+*/
+class MemoryHooks
+{
+private:
+    struct Hook
+    {
+        HookType type;
+        DoubleByte first;
+        DoubleByte last;
+        MemoryHook callback;
+        void* user;
+    };
+
+    std::vector<Hook> mHooks;
+
+    // one bit per page, for each type of hook
+    uint64_t mWatchedPages[3][4];
+
+public:
+    MemoryHooks();
+
+    // makes callback run on every access of the given type to the bytes from first to last (inclusive)
+    void add(HookType type, DoubleByte first, DoubleByte last, MemoryHook callback, void* user);
+
+    bool isPageWatched(HookType type, int page)    { return mWatchedPages[(int)type][page / 64] & (1ULL << (page % 64)); }
+    bool isWatched(HookType type, DoubleByte addr) { return isPageWatched(type, addr >> 8); }
+
+    // code in a page that this is true for can't be cached, as execute hooks have to be ran before every opcode and read hooks have to
+    // be told about every opcode and operand that is fetched
+    bool isCodeWatched(DoubleByte addr) { return isWatched(HookType::EXECUTE, addr) || isWatched(HookType::READ, addr); }
+
+    // runs every hook of the given type that is watching addr
+    void run(HookType type, DoubleByte addr, Byte val);
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifdef HERMES_PROFILE_OPCODES
+
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#include "OpcodeProfiler.h"
+
+DoubleByte OpcodeProfiler::mHistory = 0;
+uint64_t OpcodeProfiler::mOpcodeCount = 0;
+uint64_t OpcodeProfiler::mPairCounts[0x10000];
+std::unordered_map<uint32_t, uint64_t> OpcodeProfiler::mTripleCounts;
+std::string OpcodeProfiler::mReportFileName;
+
+void OpcodeProfiler::start(const char* romName)
+{
+    mReportFileName = std::string(romName) + ".profile";
+
+    // the emulator only ever stops by calling exit, so the report is written from there
+    atexit(writeReport);
+}
+
+// writes the sequences that were executed the most, along with how much of the total they make up
+void OpcodeProfiler::writeReport()
+{
+    FILE* file = fopen(mReportFileName.c_str(), "w");
+    if (file == NULL)
+    {
+        printf("Failed to write the opcode profile to %s!\n", mReportFileName.c_str());
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, uint32_t>> pairs;
+    for (uint32_t pair = 0; pair < 0x10000; pair++)
+        if (mPairCounts[pair])
+            pairs.push_back({ mPairCounts[pair], pair });
+
+    std::vector<std::pair<uint64_t, uint32_t>> triples;
+    for (auto& triple : mTripleCounts)
+        triples.push_back({ triple.second, triple.first });
+
+    // sort the most common sequences to the front
+    std::sort(pairs.rbegin(), pairs.rend());
+    std::sort(triples.rbegin(), triples.rend());
+
+    fprintf(file, "%llu opcodes executed\n\npairs:\n", (unsigned long long)mOpcodeCount);
+    for (size_t index = 0; index < pairs.size() && index < REPORT_LENGTH; index++)
+        fprintf(file, "%02X %02X          %12llu  %6.2f%%\n", pairs[index].second >> 8, pairs[index].second & 0xFF,
+                (unsigned long long)pairs[index].first, 100.0 * pairs[index].first / mOpcodeCount);
+
+    fprintf(file, "\ntriples:\n");
+    for (size_t index = 0; index < triples.size() && index < REPORT_LENGTH; index++)
+        fprintf(file, "%02X %02X %02X       %12llu  %6.2f%%\n", triples[index].second >> 16, (triples[index].second >> 8) & 0xFF,
+                triples[index].second & 0xFF, (unsigned long long)triples[index].first, 100.0 * triples[index].first / mOpcodeCount);
+
+    fclose(file);
+}
+
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#ifdef HERMES_PROFILE_OPCODES
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+#include "Constants.h"
+
+/*
+    the opcode profiler counts how often every pair and triple of opcodes is executed back to back, which shows which sequences are
+    worth turning into superinstructions. it is only built with HERMES_PROFILE_OPCODES, as counting every opcode slows everything down.
+    the most common sequences are written to <ROM file>.profile when the emulator exits
+*/
+class OpcodeProfiler
+{
+private:
+    // how many of the most common pairs and triples are written to the report
+    static const int REPORT_LENGTH = 32;
+
+    // the last two opcodes that were executed (the most recent one in the lower byte)
+    static DoubleByte mHistory;
+    static uint64_t mOpcodeCount;
+
+    // pairs are indexed by (first opcode << 8) | second opcode, and triples are keyed the same way with 3 opcodes
+    static uint64_t mPairCounts[0x10000];
+    static std::unordered_map<uint32_t, uint64_t> mTripleCounts;
+
+    static std::string mReportFileName;
+
+    static void writeReport();
+
+public:
+    // starts profiling the given ROM. the report is written to the ROM's name + .profile once the program exits
+    static void start(const char* romName);
+
+    // called after every opcode is executed
+    static void record(Byte opcode)
+    {
+        if (mOpcodeCount >= 2)
+            mTripleCounts[(uint32_t(mHistory) << 8) | opcode]++;
+        if (mOpcodeCount >= 1)
+            mPairCounts[DoubleByte(mHistory << 8) | opcode]++;
+
+        mHistory = (mHistory << 8) | opcode;
+        mOpcodeCount++;
+    }
+};
+
+#endif
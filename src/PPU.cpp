@@ -24,6 +24,12 @@ const DoubleByte SCROLL_X_OFFSET = 0xFF43;
 const DoubleByte WINDOW_Y_OFFSET = 0xFF4A;
 const DoubleByte WINDOW_X_OFFSET = 0xFF4B;
 
+// how many ticks the PPU spends in each of its states before moving on to the next one
+const int SEARCH_OAM_TICKS      = 80;
+const int RENDER_SCANLINE_TICKS = 172;
+const int HBLANK_TICKS          = 204;
+const int SCANLINE_TICKS        = 456; // every line of the vblank takes as long as a whole scanline
+
 enum LCDStatBits
 {
     STAT_LYC_EQUALS_LY_INTERRUPT = 0x40,
@@ -64,6 +70,62 @@ void PPU::init(MMU* mmu)
 
     // point the LCDC pointer to the correct place in ram memory
     mLCDC = &mMMU->ramMemory[LCDC_OFFSET - RAM_OFFSET];
+
+    mSyncTicks  = 0;
+    mLCDEnabled = *mLCDC & LCD_ENABLE;
+
+    mPendingLines = 0;
+}
+
+void PPU::setIOHandlers(MMU* mmu, Scheduler* scheduler, uint64_t* ticks)
+{
+    mMMU       = mmu;
+    mScheduler = scheduler;
+    mTicks     = ticks;
+
+    // everything that rendering reads has to let the scanlines that were put off be rendered first
+    mmu->setIOHandlers(LCDC_OFFSET, this, NULL, writeLCDC);
+    mmu->setIOHandlers(SCROLL_Y_OFFSET, this, NULL, writeRenderedRegister);
+    mmu->setIOHandlers(SCROLL_X_OFFSET, this, NULL, writeRenderedRegister);
+    mmu->setIOHandlers(WINDOW_Y_OFFSET, this, NULL, writeRenderedRegister);
+    mmu->setIOHandlers(WINDOW_X_OFFSET, this, NULL, writeRenderedRegister);
+    mmu->setIOHandlers(BG_PALETTE_OFFSET, this, NULL, writePalette);
+    mmu->setIOHandlers(S0_PALETTE_OFFSET, this, NULL, writePalette);
+    mmu->setIOHandlers(S1_PALETTE_OFFSET, this, NULL, writePalette);
+}
+
+// turning the screen on or off changes when the PPU has to be updated
+void PPU::writeLCDC(void* ppu, DoubleByte addr, Byte val)
+{
+    PPU* self = (PPU*)ppu;
+
+    self->catchUp();
+    self->getRegister(addr) = val;
+    self->mScheduler->schedule(Event::PPU, *self->mTicks);
+}
+
+void PPU::writeRenderedRegister(void* ppu, DoubleByte addr, Byte val)
+{
+    PPU* self = (PPU*)ppu;
+
+    self->catchUp();
+    self->getRegister(addr) = val;
+}
+
+void PPU::writePalette(void* ppu, DoubleByte addr, Byte val)
+{
+    PPU* self = (PPU*)ppu;
+
+    self->catchUp();
+
+    if (addr == BG_PALETTE_OFFSET)
+        Display::updateBackgroundPalette(val);
+    else if (addr == S0_PALETTE_OFFSET)
+        Display::updateSpritePalette0(val);
+    else
+        Display::updateSpritePalette1(val);
+
+    self->getRegister(addr) = val;
 }
 
 // startingXPixel and endingXPixel are default parameters set to 0 and 7 respectively
@@ -75,7 +137,7 @@ void PPU::renderTile(DoubleByte tileMapAddr, Byte scx, Byte rightMostPixel, Byte
         tileNum -= 32;
 
     // reading the ID of the tile consists of reading into the OAM and indexing the number of tiles pushed to FIFO so far in
-    mTileID = mMMU->readByte(tileMapAddr + tileNum);
+    mTileID = readVideoMemory(tileMapAddr + tileNum);
 
     /* 
         reading the data in tile's consists of finding the offset into the VRAM that we need to index
@@ -94,13 +156,13 @@ void PPU::renderTile(DoubleByte tileMapAddr, Byte scx, Byte rightMostPixel, Byte
 
     // determine which addressing mode to use based on if bit 4 of the LCDC register is set
     if (*mLCDC & BG_AND_WINDOW_TILE_MAP)
-        mPixelDataBuffer = mMMU->readByte(VRAM_BLOCK_0_OFFSET + (mTileID * 16) + (mTileLine * 2));
+        mPixelDataBuffer = readVideoMemory(VRAM_BLOCK_0_OFFSET + (mTileID * 16) + (mTileLine * 2));
     else
     {
         if (mTileID < 128)
-            mPixelDataBuffer = mMMU->readByte(VRAM_BLOCK_2_OFFSET + (mTileID * 16) + (mTileLine * 2));
+            mPixelDataBuffer = readVideoMemory(VRAM_BLOCK_2_OFFSET + (mTileID * 16) + (mTileLine * 2));
         else
-            mPixelDataBuffer = mMMU->readByte(VRAM_BLOCK_1_OFFSET + ((mTileID - 128) * 16) + (mTileLine * 2));
+            mPixelDataBuffer = readVideoMemory(VRAM_BLOCK_1_OFFSET + ((mTileID - 128) * 16) + (mTileLine * 2));
     }
 
     // iterate over all the bits in the buffer and set the values of the pixel data to 1 or 0
@@ -109,13 +171,13 @@ void PPU::renderTile(DoubleByte tileMapAddr, Byte scx, Byte rightMostPixel, Byte
 
     // if we are reading the second of the two bytes that each tile takes up, then index an extra 1 byte
     if (*mLCDC & BG_AND_WINDOW_TILE_MAP)
-        mPixelDataBuffer = mMMU->readByte(VRAM_BLOCK_0_OFFSET + (mTileID * 16) + (mTileLine * 2) + 1);
+        mPixelDataBuffer = readVideoMemory(VRAM_BLOCK_0_OFFSET + (mTileID * 16) + (mTileLine * 2) + 1);
     else
     {
         if (mTileID < 128)
-            mPixelDataBuffer = mMMU->readByte(VRAM_BLOCK_2_OFFSET + (mTileID * 16) + (mTileLine * 2) + 1);
+            mPixelDataBuffer = readVideoMemory(VRAM_BLOCK_2_OFFSET + (mTileID * 16) + (mTileLine * 2) + 1);
         else
-            mPixelDataBuffer = mMMU->readByte(VRAM_BLOCK_1_OFFSET + ((mTileID - 128) * 16) + (mTileLine * 2) + 1);
+            mPixelDataBuffer = readVideoMemory(VRAM_BLOCK_1_OFFSET + ((mTileID - 128) * 16) + (mTileLine * 2) + 1);
     }
 
     // iterate over all the bits in the buffer and set the values of the pixel data to 1 or 0
@@ -140,7 +202,7 @@ void PPU::renderTile(DoubleByte tileMapAddr, Byte scx, Byte rightMostPixel, Byte
 
 void PPU::renderSprites()
 {
-    Byte scy = mMMU->readByte(SCROLL_Y_OFFSET);
+    Byte scy = getRegister(SCROLL_Y_OFFSET);
 
     // determine the height of the sprite by reading the second bit of the LCDC
     Byte spriteHeight = (*mLCDC & SPRITE_HEIGHT) ? 16 : 8;
@@ -153,21 +215,21 @@ void PPU::renderSprites()
         Byte index = 4 * sprite;
 
         // read in the ypos (subtracting 16 from this value is necessary to get the proper ypos due to how the gameboy lays out its pixels)
-        short ypos = mMMU->readByte(SPRITE_DATA_OFFSET + index) - 16;
+        short ypos = readVideoMemory(SPRITE_DATA_OFFSET + index) - 16;
 
         // if the sprite should be drawn on this scanline 
         if (ly >= ypos && ly < ypos + spriteHeight) // each sprite is 8 pixels high (for now this is all that is supported)
         {
             // read in the xpos (subtracting 8 from this value is necessary to get the proper xpos due to how the gameboy lays out its pixels)
-            Byte xpos = mMMU->readByte(SPRITE_DATA_OFFSET + index + 1) - 8;
+            Byte xpos = readVideoMemory(SPRITE_DATA_OFFSET + index + 1) - 8;
 
-            Byte tileLocation = mMMU->readByte(SPRITE_DATA_OFFSET + index + 2);
+            Byte tileLocation = readVideoMemory(SPRITE_DATA_OFFSET + index + 2);
 
             if (spriteHeight == 16)
                 tileLocation &= ~1;
 
             // read in the attributes of the sprite
-            Byte attributes = mMMU->readByte(SPRITE_DATA_OFFSET + index + 3);
+            Byte attributes = readVideoMemory(SPRITE_DATA_OFFSET + index + 3);
 
             // this variable stores the row number of the sprite we're drawing. i.e., which row we're going to draw from the sprite's 8 pixel height
             int spriteLine = ly - ypos;
@@ -178,8 +240,8 @@ void PPU::renderSprites()
             spriteLine *= 2; // 2 bytes for the 8 pixels
 
             DoubleByte spriteDataAddr = VRAM_BLOCK_0_OFFSET + tileLocation * 16 + spriteLine;
-            Byte pixelData0 = mMMU->readByte(spriteDataAddr);
-            Byte pixelData1 = mMMU->readByte(spriteDataAddr + 1);
+            Byte pixelData0 = readVideoMemory(spriteDataAddr);
+            Byte pixelData1 = readVideoMemory(spriteDataAddr + 1);
 
             // draw the sprite right to left if the sprite is flipped horizontally
             if (attributes & X_FLIP)
@@ -214,7 +276,7 @@ void PPU::renderSprites()
 void PPU::renderBackground()
 {     
     // read the scroll y register
-    Byte scy = mMMU->readByte(SCROLL_Y_OFFSET);
+    Byte scy = getRegister(SCROLL_Y_OFFSET);
 
     /* 
         the ly ranges from 0 - 144, each tile in the tilemap is 8x8 pixels, so we divide by 8, and there are 32 tiles in a row, so we multiply by 32 to get to the next row
@@ -231,7 +293,7 @@ void PPU::renderBackground()
     // get which row of the tile we're looking at (can be any number from 0-7 for all 8 pixels of the tile's height)
     mTileLine = Byte(ly + scy) % 8;
 
-    Byte scx = mMMU->readByte(SCROLL_X_OFFSET);
+    Byte scx = getRegister(SCROLL_X_OFFSET);
 
     /*
         render all the tiles from left to right
@@ -254,12 +316,12 @@ void PPU::renderBackground()
 void PPU::renderWindow()
 {
     // read in the window Y register
-    Byte windowY = mMMU->readByte(WINDOW_Y_OFFSET);
+    Byte windowY = getRegister(WINDOW_Y_OFFSET);
 
     // if this scanline is on the same row or underneath the row that the window has its upper left corner on, we want to draw
     if (ly >= windowY)
     {
-        x = mMMU->readByte(WINDOW_X_OFFSET) - 7;
+        x = getRegister(WINDOW_X_OFFSET) - 7;
 
         // some ROMs set the x position of the window to an off screen value to indicate that the window is disabled
         // this means that the internal counter would not get incremented! and thus, we return when x is greater or equal to 16
@@ -288,22 +350,80 @@ void PPU::renderWindow()
     }
 }
 
+void PPU::renderScanline()
+{
+    // set x to the leftmost pixel (so we start rendering form the left side of the screen to the right)
+    x = 0;
+
+    if (*mLCDC & BG_ENABLE)
+        renderBackground();
+
+    if (*mLCDC & WINDOW_ENABLE)
+        renderWindow();
+
+    if (*mLCDC & SPRITE_ENABLE)
+        renderSprites();
+}
+
+// renders all the scanlines that were put off, in one go. the registers, VRAM and OAM still hold what they did when the PPU reached
+// those lines, as writing to any of them renders the lines first
+void PPU::renderPendingLines()
+{
+    int currentLine = ly;
+
+    for (ly = mFirstPendingLine; ly < mFirstPendingLine + mPendingLines; ly++)
+        renderScanline();
+
+    ly = currentLine;
+    mPendingLines = 0;
+}
+
 void PPU::checkLycCoincidence()
 {
-    Byte lyc = mMMU->readByte(LYC_OFFSET);
-    mSTAT    =  mMMU->readByte(STAT_LCD_OFFSET);
+    Byte lyc = getRegister(LYC_OFFSET);
+    mSTAT    =  getRegister(STAT_LCD_OFFSET);
 
     // compare LYC and LY. set the second bit of the register if they are equal, and reset it otherwise
     if (ly == lyc)
     {
-        mMMU->writeByte(STAT_LCD_OFFSET, mSTAT | 0x4);
+        getRegister(STAT_LCD_OFFSET) = mSTAT | 0x4;
 
         // cause a stat interrupt if the LYC = LY stat interrupt source is enabled
         if (mSTAT & STAT_LYC_EQUALS_LY_INTERRUPT)
             mMMU->writeByte(INTERRUPT_OFFSET, mMMU->readByte(INTERRUPT_OFFSET) | (Byte)Interrupts::LCD_STAT);
     }
     else
-        mMMU->writeByte(STAT_LCD_OFFSET, mSTAT & ~0x4);
+        getRegister(STAT_LCD_OFFSET) = mSTAT & ~0x4;
+}
+
+void PPU::update(uint64_t ticks, int deltaTicks)
+{
+    // the ticks before the last instruction went by with the screen on or off, the same as it was before that instruction
+    if (mLCDEnabled)
+        mPPUTicks += (ticks - deltaTicks) - mSyncTicks;
+
+    mSyncTicks  = ticks;
+    mLCDEnabled = *mLCDC & LCD_ENABLE;
+
+    // the last instruction's ticks count as long as the screen is on after it
+    tick(deltaTicks);
+}
+
+// the PPU only ever changes what the CPU can see (the LY and STAT registers, the interrupt flags and the screen) when it moves on
+// to its next state, so nothing has to happen until then
+uint64_t PPU::getNextStateTicks()
+{
+    // nothing happens at all while the screen is off
+    if (!mLCDEnabled)
+        return Scheduler::NEVER;
+
+    switch (mState)
+    {
+        case SEARCH_OAM:      return mSyncTicks + SEARCH_OAM_TICKS - mPPUTicks;
+        case RENDER_SCANLINE: return mSyncTicks + RENDER_SCANLINE_TICKS - mPPUTicks;
+        case HBLANK:          return mSyncTicks + HBLANK_TICKS - mPPUTicks;
+        default:              return mSyncTicks + SCANLINE_TICKS - mPPUTicks;
+    }
 }
 
 void PPU::tick(int ticks)
@@ -317,16 +437,16 @@ void PPU::tick(int ticks)
     switch (mState)
     {   
         case SEARCH_OAM:
-            if (mPPUTicks >= 80)
+            if (mPPUTicks >= SEARCH_OAM_TICKS)
             {
                 mInternalWindowCounter = 0;
                 mState = RENDER_SCANLINE;
                 mPPUTicks = 0;
 
-                mSTAT = mMMU->readByte(STAT_LCD_OFFSET);
+                mSTAT = getRegister(STAT_LCD_OFFSET);
                 // update the mode of the STAT register with the current state of the PPU
                 mSTAT &= ~0x3; // reset the bottom 2 bits of the stat register
-                mMMU->writeByte(STAT_LCD_OFFSET, mSTAT | RENDERING_SCANLINE_MODE);
+                getRegister(STAT_LCD_OFFSET) = mSTAT | RENDERING_SCANLINE_MODE;
             }
 
             break;
@@ -334,28 +454,22 @@ void PPU::tick(int ticks)
         // get all the pixels in the scanline and render them to the screen
         case RENDER_SCANLINE:            
             
-            if (mPPUTicks >= 172)
+            if (mPPUTicks >= RENDER_SCANLINE_TICKS)
             {
-                // set x to the leftmost pixel (so we start rendering form the left side of the screen to the right)
-                x = 0;
-
-                if (*mLCDC & BG_ENABLE)
-                    renderBackground();
-
-                if (*mLCDC & WINDOW_ENABLE)
-                    renderWindow();
-
-                if (*mLCDC & SPRITE_ENABLE)
-                    renderSprites();
+                // the scanline isn't rendered yet, only once something that rendering reads is about to change (or the frame is
+                // drawn). lines are only ever reached in order, so the ones that are waiting always follow on from the first one
+                if (!mPendingLines)
+                    mFirstPendingLine = ly;
+                mPendingLines++;
 
-                mSTAT = mMMU->readByte(STAT_LCD_OFFSET);
+                mSTAT = getRegister(STAT_LCD_OFFSET);
                 // cause a stat interrupt if the hblank stat interrupt is enabled
                 if (mSTAT & STAT_HBLANK_INTERRUPT)
                     mMMU->writeByte(INTERRUPT_OFFSET, mMMU->readByte(INTERRUPT_OFFSET) | ((Byte)Interrupts::LCD_STAT));
 
                 // update the mode of the STAT register with the current state of the PPU
                 mSTAT &= ~0x3; // reset the bottom 2 bits of the stat register
-                mMMU->writeByte(STAT_LCD_OFFSET, mSTAT | HBLANK_MODE);
+                getRegister(STAT_LCD_OFFSET) = mSTAT | HBLANK_MODE;
 
                  mPPUTicks = 0;
                  mState = HBLANK;
@@ -364,7 +478,7 @@ void PPU::tick(int ticks)
             break;
         
         case HBLANK:
-            if (mPPUTicks >= 204)
+            if (mPPUTicks >= HBLANK_TICKS)
             {
                 // reset the number of PPU ticks, as we are now starting on a new line
                 mPPUTicks = 0;
@@ -372,35 +486,36 @@ void PPU::tick(int ticks)
                 // increment the yline, meaning that we are now looking at a different scanline
                 ly++;
                 checkLycCoincidence();
-                mMMU->writeByte(LY_OFFSET, ly);
+                getRegister(LY_OFFSET) = ly;
 
                 // if the ly equals 144, then it has gone through the entirety of the screen (which has a height of 144 scanlines)
                 if (ly == 144)
                 {
-                    // update the display
+                    // update the display, once every line on it has been rendered
+                    catchUp();
                     mDisplay.drawFrame();
 
                     // set the interupt flag for vblanking
                     mMMU->writeByte(INTERRUPT_OFFSET, mMMU->readByte(INTERRUPT_OFFSET) | ((Byte)Interrupts::VBLANK));
 
-                    mSTAT =  mMMU->readByte(STAT_LCD_OFFSET);
+                    mSTAT =  getRegister(STAT_LCD_OFFSET);
                     // cause a stat interrupt if the vblank stat interrupt source is enabled in the STAT register
                     if (mSTAT & STAT_VBLANK_INTERRUPT)
                         mMMU->writeByte(INTERRUPT_OFFSET, mMMU->readByte(INTERRUPT_OFFSET) | ((Byte)Interrupts::LCD_STAT));
 
                     // update the mode of the STAT register with the current state of the PPU
                     mSTAT &= ~0x3; // reset the bottom 2 bits of the stat register
-                    mMMU->writeByte(STAT_LCD_OFFSET, mSTAT | VBLANK_MODE);
+                    getRegister(STAT_LCD_OFFSET) = mSTAT | VBLANK_MODE;
 
                     // update state
                     mState = VBLANK;
                 }
                 else
                 {
-                    mSTAT = mMMU->readByte(STAT_LCD_OFFSET);
+                    mSTAT = getRegister(STAT_LCD_OFFSET);
                     // update the mode of the STAT register with the current state of the PPU
                     mSTAT &= ~0x3; // reset the bottom 2 bits of the stat register
-                    mMMU->writeByte(STAT_LCD_OFFSET, mSTAT | RENDERING_SCANLINE_MODE);
+                    getRegister(STAT_LCD_OFFSET) = mSTAT | RENDERING_SCANLINE_MODE;
 
                     mState = RENDER_SCANLINE; // if the ly does not equal 144, then we want to again search the OAM, and repeat this process
                 }
@@ -410,7 +525,7 @@ void PPU::tick(int ticks)
 
         case VBLANK:
 
-            if (mPPUTicks >= 456)
+            if (mPPUTicks >= SCANLINE_TICKS)
             {
                 ly++;
 
@@ -427,10 +542,10 @@ void PPU::tick(int ticks)
 
                     // update the mode of the STAT register with the current state of the PPU
                     mSTAT &= ~0x3; // reset the bottom 2 bits of the stat register
-                    mMMU->writeByte(STAT_LCD_OFFSET, mSTAT | OAM_SEARCH_MODE);
+                    getRegister(STAT_LCD_OFFSET) = mSTAT | OAM_SEARCH_MODE;
                 }
 
-                mMMU->writeByte(LY_OFFSET, ly);
+                getRegister(LY_OFFSET) = ly;
 
                 mPPUTicks = 0;
             }
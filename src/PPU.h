@@ -5,6 +5,7 @@
 #include "Constants.h"
 #include "Display.h"
 #include "MMU.h"
+#include "Scheduler.h"
 
 // the PPU (picture processing unit) handles the graphics
 class PPU
@@ -87,15 +88,64 @@ private:
 
     Byte mInternalWindowCounter;
 
+    // the scanlines that the PPU has gone past without rendering them yet. the MMU can write to VRAM before the PPU is initialized,
+    // so there mustn't appear to be any until then
+    int mFirstPendingLine;
+    int mPendingLines = 0;
+
     void renderTile(DoubleByte tileMapAddr, Byte scx, Byte startingXPixel = 0, Byte endingXPixel = 7);
     void renderSprites();
     void renderBackground();
     void renderWindow();
 
+    // renders the scanline at ly
+    void renderScanline();
+    void renderPendingLines();
+
     // checks for the LY = LYC stat interrupt
     void checkLycCoincidence();
 
+    // the CPU's tick count that the PPU has been updated up to, and whether the screen was on as of then
+    uint64_t mSyncTicks;
+    bool mLCDEnabled;
+
+    // counts the given number of ticks, moving on to the next state if enough have gone by
+    void tick(int ticks);
+
+    // the CPU's scheduler and tick count, for when writing to the LCDC register changes when the PPU has to be updated
+    Scheduler* mScheduler;
+    uint64_t* mTicks;
+
+    // the PPU's registers live in the MMU's memory, and none of them do anything special when the PPU itself reads or writes them
+    Byte& getRegister(DoubleByte addr) { return mMMU->ramMemory[addr - RAM_OFFSET]; }
+
+    // the PPU has its own bus to VRAM and OAM, so it reads them directly (OAM DMA blocks the CPU from them, but not the PPU)
+    Byte readVideoMemory(DoubleByte addr) { return mMMU->ramMemory[addr - RAM_OFFSET]; }
+
+    // the MMU's handlers for the registers that rendering reads
+    static void writeLCDC(void* ppu, DoubleByte addr, Byte val);
+    static void writeRenderedRegister(void* ppu, DoubleByte addr, Byte val);
+    static void writePalette(void* ppu, DoubleByte addr, Byte val);
+
 public:
     void init(MMU* mmu);
-    void tick(int ticks);
+
+    // makes the MMU go through the PPU for the registers that it renders from. this is done by the MMU before it writes their
+    // starting values, which is before the PPU is initialized
+    void setIOHandlers(MMU* mmu, Scheduler* scheduler, uint64_t* ticks);
+
+    // catches the PPU up to the given tick count, which is the end of an instruction that took deltaTicks. it only needs to be called
+    // once the PPU is due to move on to its next state, or after the LCDC register was written to (which might turn the screen on or off)
+    void update(uint64_t ticks, int deltaTicks);
+
+    // returns the tick that the PPU will move on to its next state at (or Scheduler::NEVER if the screen is off)
+    uint64_t getNextStateTicks();
+
+    // renders every scanline that the PPU has gone past so far. this has to be called before anything that rendering reads changes:
+    // VRAM, OAM, and the LCDC, scroll, palette and window registers
+    void catchUp()
+    {
+        if (mPendingLines)
+            renderPendingLines();
+    }
 };
\ No newline at end of file
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "ROMCache.h"
+
+#include "MemoryChips/MBC.h"
+
+// where the game's title is kept in the header
+const DoubleByte HEADER_TITLE      = 0x134;
+const int        HEADER_TITLE_SIZE = 16;
+
+// the header ends at 0x14F, so this is all that has to be read to know how many banks the cartridge has
+const size_t HEADER_SIZE = 0x150;
+
+// ROMs at least this big (the largest MBC5 games) ask for their memory to be backed by huge pages, if the system supports it
+const size_t HUGE_ROM_SIZE = 0x400000;
+
+// an image that has been loaded, along with what the file looked like when it was. the cache doesn't keep images alive itself
+struct CachedImage
+{
+    std::weak_ptr<const ROMImage> image;
+    off_t size;
+    time_t modified;
+};
+
+// the images are kept by the canonical path of their file (see getCanonicalPath), and by every path that they have been loaded with, so
+// that loading an image that is still alive with the same path again doesn't have to touch the disk at all
+static std::map<std::string, CachedImage> sImages;
+static std::map<std::string, std::weak_ptr<const ROMImage>> sPaths;
+static std::mutex sImagesMutex;
+
+// returns the absolute path of the file, with any symbolic links, "." and ".." resolved, so that every path to a file gives the same one
+static std::string getCanonicalPath(const char* romDir)
+{
+#ifdef _WIN32
+    char path[_MAX_PATH];
+    if (_fullpath(path, romDir, _MAX_PATH) == NULL)
+    {
+        printf("ROM file failed to load! Was the directory provided incorrect?");
+        exit(-1);
+    }
+
+    return path;
+#else
+    char* path = realpath(romDir, NULL);
+    if (path == NULL)
+    {
+        printf("ROM file failed to load! Was the directory provided incorrect?");
+        exit(-1);
+    }
+
+    std::string canonicalPath = path;
+    free(path);
+
+    return canonicalPath;
+#endif
+}
+
+// deletes an image once the last emulator using it is gone. its entries in the cache (and any others that have expired since) are
+// thrown away first, so that the cache only ever holds the images that are alive
+static void releaseImage(ROMImage* image)
+{
+    {
+        std::lock_guard<std::mutex> lock(sImagesMutex);
+
+        for (auto entry = sImages.begin(); entry != sImages.end();)
+            entry = entry->second.image.expired() ? sImages.erase(entry) : std::next(entry);
+
+        for (auto entry = sPaths.begin(); entry != sPaths.end();)
+            entry = entry->second.expired() ? sPaths.erase(entry) : std::next(entry);
+    }
+
+    delete image;
+}
+
+// works out how much memory has to be set aside for the ROM, which is every bank of the file and every bank that the header says the
+// cartridge has (the memory bank controllers wrap the selected bank around at that many banks, so they can never select a bank past the
+// end of the memory), rounded up to a whole number of banks that is a power of two
+static void setBanks(const Byte* header, size_t romSize, ROMImage& image)
+{
+    size_t numBanks = std::max<size_t>((romSize + ROM_BANK_SIZE - 1) / ROM_BANK_SIZE, 2);
+
+    int numHeaderBanks = Cartridge::getNumRomBanks(header);
+    numBanks = std::max<size_t>(numBanks, std::max(numHeaderBanks, 0));
+
+    size_t numMappedBanks = 2;
+    while (numMappedBanks < numBanks)
+        numMappedBanks *= 2;
+
+    image.mappedSize = numMappedBanks * ROM_BANK_SIZE;
+
+    // the header's number of banks is always a power of two, but if it isn't one the header knows of, every bank of the memory is used
+    image.numRomBanks = numHeaderBanks > 0 ? numHeaderBanks : numMappedBanks;
+}
+
+/*
+    the ROM is mapped straight from the file instead of being read into a copy of its own, which means that starting up doesn't have to
+    read the whole file, and that every emulator running the same game shares the same physical memory for it. the mapping is read only,
+    so nothing can ever write to the ROM. it always covers every bank that can be selected (see setBanks), even if the file is shorter
+    than that, with the part past the end of the file reading as 0
+*/
+static void mapROMFile(const char* romDir, size_t romSize, ROMImage& image)
+{
+    image.size = romSize;
+
+    // anything past the end of the file reads as 0, the same as it does in the memory
+    Byte header[HEADER_SIZE] = {};
+
+#ifdef _WIN32
+    // open the file provided by the directory as binary
+    FILE* romFile = fopen(romDir, "rb");
+    if (romFile == NULL)
+    {
+        printf("ROM file failed to load! Was the directory provided incorrect?");
+        exit(-1);
+    }
+
+    fread(header, 1, HEADER_SIZE, romFile);
+    rewind(romFile);
+
+    setBanks(header, romSize, image);
+
+    Byte* memory = new Byte[image.mappedSize]();
+
+    // load the ROM file into memory
+    fread(memory, romSize, 1, romFile); // fills the ROM's memory with the data provided by the ROM file
+    fclose(romFile);
+
+    image.memory = memory;
+#else
+    int romFile = open(romDir, O_RDONLY);
+    if (romFile == -1)
+    {
+        printf("ROM file failed to load! Was the directory provided incorrect?");
+        exit(-1);
+    }
+
+    if (pread(romFile, header, HEADER_SIZE, 0) == -1)
+    {
+        printf("ROM file failed to load! Was the directory provided incorrect?");
+        exit(-1);
+    }
+
+    setBanks(header, romSize, image);
+
+    // zeroed memory is set aside for all of the banks first, and then as much of it as the file covers is replaced by the file itself
+    void* memory = mmap(NULL, image.mappedSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory != MAP_FAILED && romSize > 0)
+        memory = mmap(memory, romSize, PROT_READ, MAP_PRIVATE | MAP_FIXED, romFile, 0);
+
+    close(romFile);
+
+    if (memory == MAP_FAILED)
+    {
+        printf("Failed to map the ROM file into memory!\n");
+        exit(-1);
+    }
+
+#ifdef MADV_HUGEPAGE
+    if (romSize >= HUGE_ROM_SIZE)
+        madvise(memory, image.mappedSize, MADV_HUGEPAGE);
+#endif
+
+    image.memory = (const Byte*)memory;
+#endif
+}
+
+ROMImage::~ROMImage()
+{
+#ifdef _WIN32
+    delete[] memory;
+#else
+    munmap((void*)memory, mappedSize);
+#endif
+}
+
+std::shared_ptr<const ROMImage> ROMCache::load(const char* romDir)
+{
+    std::lock_guard<std::mutex> lock(sImagesMutex);
+
+    // an image that is still alive is shared with anything else that loads it through the same path, without looking at the file again
+    auto path = sPaths.find(romDir);
+    if (path != sPaths.end())
+        if (std::shared_ptr<const ROMImage> image = path->second.lock())
+            return image;
+
+    std::string canonicalPath = getCanonicalPath(romDir);
+
+    struct stat romStat;
+    if (stat(canonicalPath.c_str(), &romStat) != 0)
+    {
+        printf("ROM file failed to load! Was the directory provided incorrect?");
+        exit(-1);
+    }
+
+    // through any other path, the image can only be shared if it is still alive, and if the file hasn't changed since it was loaded
+    CachedImage& cachedImage = sImages[canonicalPath];
+    if (cachedImage.size == romStat.st_size && cachedImage.modified == romStat.st_mtime)
+    {
+        if (std::shared_ptr<const ROMImage> image = cachedImage.image.lock())
+        {
+            sPaths[romDir] = image;
+            return image;
+        }
+    }
+
+    std::shared_ptr<ROMImage> image(new ROMImage(), releaseImage);
+    mapROMFile(canonicalPath.c_str(), romStat.st_size, *image);
+
+    image->type        = Cartridge::getType(image->memory);
+    image->numRamBanks = Cartridge::getNumRamBanks(image->memory);
+
+    memcpy(image->title, &image->memory[HEADER_TITLE], HEADER_TITLE_SIZE);
+    image->title[HEADER_TITLE_SIZE] = '\0';
+
+    // this replaces the entry of an image that was loaded before the file changed, which is released once nothing is using it anymore
+    cachedImage = { image, romStat.st_size, romStat.st_mtime };
+    sPaths[romDir] = image;
+
+    return image;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "Cartridge.h"
+#include "Constants.h"
+
+// a ROM file that has been mapped into memory, along with what its header says about it. it never changes once it is loaded, so any
+// number of emulators (on any number of threads) can share it
+struct ROMImage
+{
+    const Byte* memory;
+    size_t size;       // the size of the file
+    size_t mappedSize; // the size of the memory, which covers a power of two of whole banks (at least two, and every bank there can be)
+
+    CartridgeType type;
+    int numRomBanks;   // never more than the memory covers
+    int numRamBanks;
+    char title[17];
+
+    ~ROMImage();
+};
+
+/*
+    the ROM cache hands out the ROM images of every game that is loaded in the process, so that loading a game that is already loaded
+    doesn't have to map it again, and so that running more instances of a game doesn't take up any more memory for its ROM. images are
+    looked up by the path they were loaded with first, which doesn't touch the disk at all. a path that hasn't been seen is resolved to
+    the file's canonical path, and an image of that file is only shared if its size and modification time haven't changed. images are
+    unmapped (and taken out of the cache) as soon as the last emulator using them is gone
+*/
+class ROMCache
+{
+public:
+    // returns the image of the ROM at romDir, loading it first if it isn't already loaded. exits if the file can't be loaded
+    static std::shared_ptr<const ROMImage> load(const char* romDir);
+};
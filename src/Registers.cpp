@@ -10,21 +10,6 @@ void Registers::reset()
     HL = 0;
     pc = 0;
     sp = 0;
-}
 
-// set the flag provided in register F
-void Registers::setFlag(Byte flag)
-{
-    F |= flag;
+    mLazyFlags = 0;
 }
-
-// clear the flag provided in register F
-void Registers::maskFlag(Byte flag)
-{
-    F &= ~flag;
-}
-
-bool Registers::isFlagSet(Byte flag)
-{
-    return F & flag;
-}
\ No newline at end of file
@@ -1,11 +1,35 @@
 #pragma once
 
+#include <array>
+
 #include "Constants.h"
 
 const Byte ZERO_FLAG       = 0x80;
 const Byte NEGATIVE_FLAG   = 0x40;
 const Byte HALF_CARRY_FLAG = 0x20;
 const Byte CARRY_FLAG      = 0x10;
+const Byte ALL_FLAGS       = ZERO_FLAG | NEGATIVE_FLAG | HALF_CARRY_FLAG | CARRY_FLAG;
+
+// builds the table of the zero and carry flags for every 9-bit result (the zero flag for the lower 8 bits being 0, and the carry flag for the 9th bit)
+constexpr std::array<Byte, 0x200> makeZeroCarryFlags()
+{
+    std::array<Byte, 0x200> flags = {};
+
+    for (int result = 0; result < 0x200; result++)
+        flags[result] = ((result & 0xFF) == 0 ? ZERO_FLAG : 0) | ((result & 0x100) ? CARRY_FLAG : 0);
+
+    return flags;
+}
+
+// generated at compile time, so that working out pending flags doesn't need any branches
+inline constexpr std::array<Byte, 0x200> ZERO_CARRY_FLAGS = makeZeroCarryFlags();
+
+// the flags that ADD, SUB (and CP), INC and DEC set, generated at compile time in opcodes.cpp. the arithmetic tables are indexed by A
+// (in the upper 8 bits) and the value, and the INC and DEC tables by the value being incremented or decremented
+extern const std::array<Byte, 0x10000> ADD_FLAGS;
+extern const std::array<Byte, 0x10000> SUB_FLAGS;
+extern const std::array<Byte, 0x100> INC_FLAGS;
+extern const std::array<Byte, 0x100> DEC_FLAGS;
 
 /*
     the registers struct contains represetnations of the gameboy's 7 registers, 
@@ -74,13 +98,81 @@ struct Registers
     // stack pointer
     DoubleByte sp;
 
+private:
+    // the JIT keeps F in a host register, so it has to be able to tell when a handler left flags pending
+    friend class JIT;
+
+    /*
+        most flags are overwritten by the next operation before anything reads them, so instead of working them out right away,
+        the ALU functions just record what they need to work them out later. the flags in mLazyFlags are the ones that are still
+        pending, and the rest of the flags in register F are up to date. the pending flags are worked out from:
+        Z: the lower 8 bits of mFlagResult being 0
+        H: bit 4 of (mFlagOperands ^ mFlagResult), which is set if there was a carry (or borrow) out of the lower 4 bits
+        C: bit 8 of mFlagResult, which is set if there was a carry (or borrow) out of the whole byte
+    */
+    Byte mLazyFlags;
+    Byte mFlagOperands;     // the two values that went into the operation, xored together
+    DoubleByte mFlagResult; // the (at least 9-bit) result of the operation
+
+public:
     // function to set all the default values of the registers
     void reset();
 
+    // works out any flags that are still pending. this has to be called before reading F (or AF) directly, or before writing to it
+    void resolveFlags()
+    {
+        if (mLazyFlags == 0)
+            return;
+
+        // bit 4 of the xor is moved up to bit 5, which is where the half-carry flag is
+        Byte flags = ZERO_CARRY_FLAGS[mFlagResult & 0x1FF] | (((mFlagOperands ^ mFlagResult) & 0x10) << 1);
+
+        F = (F & ~mLazyFlags) | (flags & mLazyFlags);
+        mLazyFlags = 0;
+    }
+
+    // records the result of an operation, leaving the given flags (any of Z, H and C) pending until they are read
+    void setLazyFlags(Byte flags, DoubleByte result, Byte operands)
+    {
+        // if a flag that this operation doesn't touch is still pending, it has to be worked out before the operation is forgotten
+        if (mLazyFlags & ~flags)
+            resolveFlags();
+
+        mLazyFlags    = flags;
+        mFlagResult   = result;
+        mFlagOperands = operands;
+    }
+
+    // sets the given flags to what they are in val all at once (for operations that look their flags up in a table), leaving the rest alone
+    void setFlags(Byte flags, Byte val)
+    {
+        // any other flag that is still pending has to be worked out first, as it is about to be forgotten
+        if (mLazyFlags & ~flags)
+            resolveFlags();
+
+        F = (F & ~flags) | val;
+        mLazyFlags = 0;
+    }
+
     // functions for clearing or setting flags in the F register
-    void setFlag(Byte flag);
-    void maskFlag(Byte flag);
+    void setFlag(Byte flag)
+    {
+        F |= flag;
+        mLazyFlags &= ~flag;
+    }
+
+    void maskFlag(Byte flag)
+    {
+        F &= ~flag;
+        mLazyFlags &= ~flag;
+    }
 
     // returns true if the flag is set, and false if otherwise
-    bool isFlagSet(Byte flag);
+    bool isFlagSet(Byte flag)
+    {
+        if (mLazyFlags & flag)
+            resolveFlags();
+
+        return F & flag;
+    }
 };
\ No newline at end of file
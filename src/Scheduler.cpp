@@ -0,0 +1,24 @@
+#include "Scheduler.h"
+
+Scheduler::Scheduler(uint64_t* nextEventTicks)
+{
+    mNextEventTicks = nextEventTicks;
+
+    for (int event = 0; event < EVENT_COUNT; event++)
+        mEvents[event] = NEVER;
+
+    *mNextEventTicks = NEVER;
+}
+
+void Scheduler::schedule(Event event, uint64_t ticks)
+{
+    mEvents[(int)event] = ticks;
+
+    // there are only a handful of events, so finding the earliest one again is quicker than keeping them sorted
+    uint64_t nextEventTicks = mEvents[0];
+    for (int index = 1; index < EVENT_COUNT; index++)
+        if (mEvents[index] < nextEventTicks)
+            nextEventTicks = mEvents[index];
+
+    *mNextEventTicks = nextEventTicks;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+// everything that happens at a certain tick, instead of having to be checked for after every instruction
+enum class Event
+{
+    PPU,        // the PPU moves on to its next state (or the LCDC register was written to)
+    TIMER,      // the TIMA register overflows
+    INTERRUPTS, // an interrupt might have to be serviced (one became pending, or interrupts were enabled while one was)
+    DMA,        // an OAM DMA transfer finishes, and the CPU can access all of memory again
+};
+
+/*
+    the scheduler keeps track of the tick that each event is next due at. the CPU only has to compare its ticks against the earliest
+    of them after every instruction, and the components only get updated once their event is due. an event that is due is always
+    handled at the end of the first instruction that reaches it, which is exactly when the components used to notice it themselves
+*/
+class Scheduler
+{
+private:
+    static const int EVENT_COUNT = 4;
+
+    // the tick that each event is due at, indexed by the event
+    uint64_t mEvents[EVENT_COUNT];
+
+    // the earliest of all the events. it is kept in the CPU's core state, as it is checked after every instruction
+    uint64_t* mNextEventTicks;
+
+public:
+    // the tick that an event which isn't scheduled is due at
+    static const uint64_t NEVER = UINT64_MAX;
+
+    Scheduler(uint64_t* nextEventTicks);
+
+    void schedule(Event event, uint64_t ticks);
+    void cancel(Event event) { schedule(event, NEVER); }
+
+    bool isDue(Event event, uint64_t ticks) { return mEvents[(int)event] <= ticks; }
+    uint64_t getEventTicks(Event event)     { return mEvents[(int)event]; }
+
+    uint64_t getNextEventTicks() { return *mNextEventTicks; }
+};
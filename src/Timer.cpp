@@ -0,0 +1,157 @@
+#include "MMU.h"
+#include "Timer.h"
+
+void Timer::init(uint64_t* ticks, MMU* mmu, Scheduler* scheduler)
+{
+    mTicks = ticks;
+    mMMU = mmu;
+    mScheduler = scheduler;
+
+    // the div register starts at 0x18 (taken from the pandocs, like the rest of the starting values in MMU::init)
+    mDivOffset = 0x18 - (*mTicks >> 8);
+
+    mTima       = 0;
+    mTimaTicks  = 0;
+    mSyncTicks  = *mTicks;
+
+    mClockSpeed   = 1024;
+    mClockEnabled = false;
+}
+
+void Timer::setIOHandlers(MMU* mmu)
+{
+    // the timer works the values of the DIV and TIMA registers out for itself, instead of keeping them in memory. TMA is only ever
+    // read by the timer, so it is left as it is
+    mmu->setIOHandlers(DIV_REGISTER_OFFSET, this, readDivRegister, writeDivRegister);
+    mmu->setIOHandlers(TIMA_REGISTER_OFFSET, this, readTimaRegister, writeTimaRegister);
+    mmu->setIOHandlers(TAC_REGISTER_OFFSET, this, NULL, writeTacRegister);
+}
+
+Byte Timer::readDivRegister(void* timer, DoubleByte addr)
+{
+    return ((Timer*)timer)->readDiv();
+}
+
+Byte Timer::readTimaRegister(void* timer, DoubleByte addr)
+{
+    return ((Timer*)timer)->readTima();
+}
+
+void Timer::writeDivRegister(void* timer, DoubleByte addr, Byte val)
+{
+    ((Timer*)timer)->writeDiv();
+}
+
+void Timer::writeTimaRegister(void* timer, DoubleByte addr, Byte val)
+{
+    ((Timer*)timer)->writeTima(val);
+}
+
+void Timer::writeTacRegister(void* timer, DoubleByte addr, Byte val)
+{
+    Timer* self = (Timer*)timer;
+
+    // unlike DIV and TIMA, TAC is still kept in memory, so that it can be read back
+    self->writeTac(val);
+    self->mMMU->ramMemory[addr - RAM_OFFSET] = val;
+}
+
+void Timer::catchUp()
+{
+    if (mClockEnabled)
+    {
+        uint64_t ticks = mTimaTicks + (*mTicks - mSyncTicks);
+        uint64_t increments = ticks / mClockSpeed;
+
+        // in case there was overflow (i.e., the cpu clock speed is 1 increment per 1024, but 1030 ticks went by, then we would set the
+        // current timer ticks to 6)
+        mTimaTicks = ticks % mClockSpeed;
+
+        // every time TIMA overflows, it is reset to the value in the TMA register and causes an interrupt
+        while (increments >= uint64_t(0x100 - mTima))
+        {
+            increments -= 0x100 - mTima;
+
+            mTima = mMMU->ramMemory[TMA_REGISTER_OFFSET - RAM_OFFSET];
+            mMMU->writeByte(INTERRUPT_OFFSET, mMMU->readByte(INTERRUPT_OFFSET) | (Byte)Interrupts::TIMER);
+        }
+
+        mTima += increments;
+    }
+
+    mSyncTicks = *mTicks;
+}
+
+void Timer::scheduleOverflow()
+{
+    if (mClockEnabled)
+        mScheduler->schedule(Event::TIMER, mSyncTicks + uint64_t(0x100 - mTima) * mClockSpeed - mTimaTicks);
+    else
+        mScheduler->cancel(Event::TIMER);
+}
+
+Byte Timer::readTima()
+{
+    // an overflow that this finds is still handled by the TIMER event, which is due by now and will schedule the next one
+    catchUp();
+    return mTima;
+}
+
+// writing to the DIV register causes it to reset to 0
+void Timer::writeDiv()
+{
+    mDivOffset = -(*mTicks >> 8);
+}
+
+void Timer::writeTima(Byte val)
+{
+    catchUp();
+    mTima = val;
+    scheduleOverflow();
+}
+
+void Timer::writeTac(Byte val)
+{
+    // the timer has to catch up with its old settings before the new ones take effect
+    catchUp();
+
+    mClockEnabled = val & 0b100;
+
+    // the two bottom bits of the value will determine the speed at which the clock should update
+    // each clock speed denotes the number of ticks per update of the clock. for instance,
+    // if the clock updates at 4096Hz, that is the equivalent of 1 increment per 1024 ticks,
+    // as it would end up being 4096 increments in 4Mhz
+    switch (val & 0b11)
+    {
+        case 0b00: // cpu clock speed divided by 1024
+            mClockSpeed = 1024;
+            break;
+        case 0b01: // cpu clock speed divided by 16
+            mClockSpeed = 16;
+            break;
+        case 0b10: // cpu clock speed divided by 64
+            mClockSpeed = 64;
+            break;
+        case 0b11: // cpu clock speed divided by 256
+            mClockSpeed = 256;
+            break;
+    }
+
+    scheduleOverflow();
+}
+
+void Timer::update()
+{
+    catchUp();
+    scheduleOverflow();
+}
+
+void Timer::setFromMemory(Byte div, Byte tima, Byte tac)
+{
+    mDivOffset = div - (*mTicks >> 8);
+
+    mTima      = tima;
+    mSyncTicks = *mTicks;
+
+    writeTac(tac);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Constants.h"
+#include "Scheduler.h"
+
+struct MMU;
+
+// timer offsets
+const DoubleByte DIV_REGISTER_OFFSET  = 0xFF04;
+const DoubleByte TIMA_REGISTER_OFFSET = 0xFF05;
+const DoubleByte TMA_REGISTER_OFFSET  = 0xFF06;
+const DoubleByte TAC_REGISTER_OFFSET  = 0xFF07;
+
+/*
+    the timer handles the DIV, TIMA and TAC registers. neither DIV nor TIMA is counted up as the CPU goes: their values are worked out
+    from the CPU's tick count whenever they are read or written to, so the only thing the timer ever schedules is TIMA overflowing
+    (which requests an interrupt, and so has to happen at the end of the instruction that reaches it)
+*/
+class Timer
+{
+private:
+    uint64_t* mTicks;
+    MMU* mMMU;
+    Scheduler* mScheduler;
+
+    // the div register goes up at every multiple of 256 ticks. its value is the tick count / 256 plus this offset (as a byte), which
+    // is what lets writing to it reset it to 0 without changing when it next goes up
+    Byte mDivOffset;
+
+    // the value of TIMA, and the number of ticks it has counted towards its next increment, as of mSyncTicks
+    Byte mTima;
+    uint32_t mTimaTicks;
+    uint64_t mSyncTicks;
+
+    // set by the TAC register. the clock speed is the number of ticks per increment of TIMA
+    DoubleByte mClockSpeed;
+    bool mClockEnabled;
+
+    // counts TIMA up to the current tick, reloading it from TMA and requesting an interrupt every time it overflows
+    void catchUp();
+
+    // schedules the next time TIMA overflows (if it ever does, with the timer's current settings)
+    void scheduleOverflow();
+
+    // the MMU's handlers for the DIV, TIMA and TAC registers
+    static Byte readDivRegister(void* timer, DoubleByte addr);
+    static Byte readTimaRegister(void* timer, DoubleByte addr);
+    static void writeDivRegister(void* timer, DoubleByte addr, Byte val);
+    static void writeTimaRegister(void* timer, DoubleByte addr, Byte val);
+    static void writeTacRegister(void* timer, DoubleByte addr, Byte val);
+
+public:
+    void init(uint64_t* ticks, MMU* mmu, Scheduler* scheduler);
+
+    // makes the MMU go through the timer for its registers
+    void setIOHandlers(MMU* mmu);
+
+    Byte readDiv() { return (*mTicks >> 8) + mDivOffset; }
+    Byte readTima();
+
+    void writeDiv();
+    void writeTima(Byte val);
+    void writeTac(Byte val);
+
+    // called once TIMA is due to overflow
+    void update();
+
+    // sets the registers to the values that a save file left in memory
+    void setFromMemory(Byte div, Byte tima, Byte tac);
+};
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+#ifdef __linux__
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "Cartridge.h"
+#include "CPU.h"
+
+#define main SDL_main
+
+// the number of ticks in a frame, and how many frames are ran if the number isn't given (a minute of gameplay)
+const int TICKS_PER_FRAME = 70224;
+const int DEFAULT_FRAMES  = 3600;
+
+// when running more than one instance, each of them runs for a scanline's worth of ticks before it is the next one's turn
+const int TICKS_PER_SLICE = 456;
+
+// the refresh rate of the gameboy's LCD was 59.73Hz
+const double FRAMES_PER_SECOND = 59.73;
+
+#ifdef __linux__
+// reads from the level 1 data cache that missed it
+const uint64_t L1D_READ_MISSES = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+
+// counts a hardware event (only while the benchmark itself is running in user space) using the kernel's performance counters. returns
+// -1 if they can't be used, which is often the case in virtual machines and containers
+static int openCounter(uint32_t type, uint64_t event)
+{
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+
+    attr.type           = type;
+    attr.size           = sizeof(attr);
+    attr.config         = event;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static uint64_t readCounter(int counter)
+{
+    uint64_t count = 0;
+    if (read(counter, &count, sizeof(count)) != sizeof(count))
+        return 0;
+
+    return count;
+}
+
+// counts the guest instructions that a single instance runs in the given number of ticks, by running the ROM again one instruction at
+// a time. nothing is pressed in the benchmark, so every instance runs exactly the same ones. a HALT that the CPU sits on only counts once
+static uint64_t countInstructions(const char* romDir, uint64_t ticks)
+{
+    CPU* cpu = new CPU;
+    Cartridge cartridge;
+    cartridge.loadROM(romDir, cpu->mmu);
+
+    uint64_t instructions = 0;
+    while (cpu->getTicks() < ticks)
+    {
+        if (!cpu->isHalted())
+            instructions++;
+
+        cpu->emulateCycle();
+    }
+
+    delete cpu;
+    return instructions;
+}
+#endif
+
+#ifdef HERMES_MEMORY_HOOKS
+// counts every access to the byte that the benchmark is watching
+static void countAccess(void* count, DoubleByte addr, Byte val)
+{
+    (*(uint64_t*)count)++;
+}
+#endif
+
+/*
+    runs a ROM for a number of frames as fast as it can (without any input), and reports how fast that was. on linux it also reports
+    how many (host) instructions, branch misses and level 1 data cache misses it took, which is what the CPU's lookup tables, JIT and
+    packed core state are meant to bring down. the window is still opened, as the PPU draws to it.
+
+    it can also run any number of instances of the ROM, taking turns on the same thread (each with its own window), to see how well the
+    state of each of them stays in the cache when they are sharing a core.
+
+    built with HERMES_MEMORY_HOOKS, it can also watch a byte of memory with read, write and execute hooks. comparing that against the
+    same build without a hook (which should be as fast as a build without HERMES_MEMORY_HOOKS) shows what hooks cost
+
+    command line arguments:
+    1st: name of the program (HermesBenchmark)
+    2nd: name of the ROM file to run
+    3rd: optional argument, containing the number of frames to run
+    4th: optional argument, containing the number of instances to run (1 if it isn't given)
+    5th: optional argument (only with HERMES_MEMORY_HOOKS), containing the address of the byte to watch in hexadecimal
+*/
+int main(int argc, char** argv)
+{
+#ifdef HERMES_MEMORY_HOOKS
+    if (argc < 2 || argc > 5)
+    {
+        printf("Invalid use of program! Usage is: HermesBenchmark <ROM file> <optional: number of frames> <optional: number of instances> "
+               "<optional: address to watch>\n");
+        return 0;
+    }
+#else
+    if (argc < 2 || argc > 4)
+    {
+        printf("Invalid use of program! Usage is: HermesBenchmark <ROM file> <optional: number of frames> <optional: number of instances>\n");
+        return 0;
+    }
+#endif
+
+    int frames    = argc >= 3 ? atoi(argv[2]) : DEFAULT_FRAMES;
+    int instances = argc >= 4 ? atoi(argv[3]) : 1;
+
+    if (frames < 1 || instances < 1)
+    {
+        printf("The number of frames and instances have to be at least 1!\n");
+        return 0;
+    }
+
+    // the cartridges keep the ROM images that the CPUs' MMUs read from alive, so they have to outlive them
+    std::vector<CPU*> cpus(instances);
+    std::vector<Cartridge> cartridges(instances);
+
+    for (int instance = 0; instance < instances; instance++)
+    {
+        cpus[instance] = new CPU;
+        cartridges[instance].loadROM(argv[1], cpus[instance]->mmu);
+    }
+
+#ifdef HERMES_MEMORY_HOOKS
+    uint64_t accesses = 0;
+    DoubleByte watchedAddr = argc == 5 ? (DoubleByte)strtol(argv[4], NULL, 16) : 0;
+
+    if (argc == 5)
+    {
+        for (CPU* cpu : cpus)
+        {
+            cpu->mmu->addHook(HookType::READ, watchedAddr, watchedAddr, countAccess, &accesses);
+            cpu->mmu->addHook(HookType::WRITE, watchedAddr, watchedAddr, countAccess, &accesses);
+            cpu->mmu->addHook(HookType::EXECUTE, watchedAddr, watchedAddr, countAccess, &accesses);
+        }
+    }
+#endif
+
+#ifdef __linux__
+    int instructionCounter = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    int branchMissCounter  = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+    int cacheMissCounter   = openCounter(PERF_TYPE_HW_CACHE, L1D_READ_MISSES);
+
+    for (int counter : { instructionCounter, branchMissCounter, cacheMissCounter })
+        if (counter != -1)
+            ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+
+    std::chrono::time_point<std::chrono::high_resolution_clock> start = std::chrono::high_resolution_clock::now();
+
+    // each instance is ran up to the same tick before the next one takes its turn, so none of them drift ahead of the others
+    uint64_t totalTicks = (uint64_t)frames * TICKS_PER_FRAME;
+    for (uint64_t ticks = TICKS_PER_SLICE; ticks < totalTicks + TICKS_PER_SLICE; ticks += TICKS_PER_SLICE)
+    {
+        uint64_t target = std::min(ticks, totalTicks);
+
+        for (CPU* cpu : cpus)
+            if (cpu->getTicks() < target)
+                cpu->runFor(target - cpu->getTicks());
+    }
+
+    std::chrono::time_point<std::chrono::high_resolution_clock> end = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+
+    // every instance's frames count, so that the numbers can be compared between different numbers of instances
+    int totalFrames = frames * instances;
+
+    printf("%d frames (%d instance%s) in %.3f seconds: %.1f frames per second (%.1fx the speed of a gameboy)\n", totalFrames, instances,
+           instances == 1 ? "" : "s", seconds, totalFrames / seconds, totalFrames / seconds / FRAMES_PER_SECOND);
+
+#ifdef HERMES_MEMORY_HOOKS
+    if (argc == 5)
+        printf("the hooks on 0x%04X were ran %llu times\n", watchedAddr, (unsigned long long)accesses);
+    else
+        printf("memory hooks are built in, but no hooks were added\n");
+#endif
+
+#ifdef __linux__
+    for (int counter : { instructionCounter, branchMissCounter, cacheMissCounter })
+        if (counter != -1)
+            ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+
+    if (instructionCounter != -1 && branchMissCounter != -1)
+    {
+        uint64_t instructions = readCounter(instructionCounter);
+        uint64_t branchMisses = readCounter(branchMissCounter);
+
+        printf("%.0f instructions and %.0f branch misses per frame (%.2f branch misses per 1000 instructions)\n",
+               (double)instructions / totalFrames, (double)branchMisses / totalFrames, branchMisses * 1000.0 / instructions);
+    }
+    else
+        printf("performance counters aren't available, so instructions and branch misses weren't counted\n");
+
+    if (cacheMissCounter != -1)
+    {
+        uint64_t cacheMisses = readCounter(cacheMissCounter);
+        uint64_t guestInstructions = countInstructions(argv[1], totalTicks) * instances;
+
+        printf("%.0f L1 data cache read misses per frame (%.4f per guest instruction)\n", (double)cacheMisses / totalFrames,
+               (double)cacheMisses / guestInstructions);
+    }
+    else
+        printf("the L1 data cache miss counter isn't available, so cache misses weren't counted\n");
+#endif
+
+    for (CPU* cpu : cpus)
+        delete cpu;
+
+    return 0;
+}
@@ -1,55 +1,133 @@
+#include <array>
 #include <iostream>
 
 #include "CPU.h"
 
-const DoubleByte INTERRUPTS_ENABLED_OFFSET = 0xFFFF;
-const DoubleByte INTERRUPTS_FLAGS_OFFSET   = 0xFF0F;
+// builds the table used by DAA. it is indexed by the N, H and C flags (as bits 10, 9 and 8) and register A, and each entry holds the
+// adjusted value of A in its lower 8 bits, and the new Z, N and C flags in its upper 8 bits (the half-carry flag is always cleared)
+constexpr std::array<DoubleByte, 0x800> makeDAATable()
+{
+    std::array<DoubleByte, 0x800> table = {};
 
-// general function for incrementing a byte (usually an 8-bit register) and checking to see if any flags should be set
-Byte CPU::incByte(Byte val)
+    for (int index = 0; index < 0x800; index++)
+    {
+        Byte flags = (index >> 8) << 4;
+        DoubleByte result = index & 0xFF;
+
+        if (flags & NEGATIVE_FLAG)
+        {
+            if (flags & HALF_CARRY_FLAG)
+                result = (result - 0x06) & 0xFF;
+
+            if (flags & CARRY_FLAG)
+                result -= 0x60;
+        }
+        else
+        {
+            if ((flags & HALF_CARRY_FLAG) || ((result & 0xF) > 9))
+                result += 0x6;
+
+            if ((flags & CARRY_FLAG) || (result > 0x9F))
+                result += 0x60;
+        }
+
+        // the subtraction flag is left alone, and the carry flag is only ever set (never cleared)
+        Byte newFlags = flags & (NEGATIVE_FLAG | CARRY_FLAG);
+
+        if ((result & 0xFF) == 0)
+            newFlags |= ZERO_FLAG;
+
+        if (result & 0x100)
+            newFlags |= CARRY_FLAG;
+
+        table[index] = (newFlags << 8) | (result & 0xFF);
+    }
+
+    return table;
+}
+
+// generated at compile time
+constexpr std::array<DoubleByte, 0x800> DAA_TABLE = makeDAATable();
+
+// builds the table of the flags that ADD (and SUB, if subtract is true) sets for every pair of A (in the upper 8 bits of the index)
+// and the value being added to or subtracted from it (in the lower 8 bits). CP sets the same flags as SUB
+constexpr std::array<Byte, 0x10000> makeArithmeticFlagsTable(bool subtract)
 {
-    // if the value in the register we are incrementing's lower bit is already equal to 0xF, then incrementing it will overflow it
-    // meaning we'd have to set the half-carry flag, and otherwise we'll have to unset it
-    if ((val & 0xF) == 0xF)
-        mRegisters.setFlag(HALF_CARRY_FLAG);
-    else
-        mRegisters.maskFlag(HALF_CARRY_FLAG);
+    std::array<Byte, 0x10000> table = {};
 
-    val++;
+    for (int index = 0; index < 0x10000; index++)
+    {
+        int a = index >> 8;
+        int val = index & 0xFF;
+
+        int result     = subtract ? a - val : a + val;
+        int halfResult = subtract ? (a & 0xF) - (val & 0xF) : (a & 0xF) + (val & 0xF);
+
+        Byte flags = subtract ? NEGATIVE_FLAG : 0;
 
-    // set the ZERO flag in register F if the result ended in a zero
-    if (val == 0)
-        mRegisters.setFlag(ZERO_FLAG);
-    else
-        mRegisters.maskFlag(ZERO_FLAG);
+        if ((result & 0xFF) == 0)
+            flags |= ZERO_FLAG;
 
-    // clear the subtraction flag (as incrementing is addition not subtraction)
-    mRegisters.maskFlag(NEGATIVE_FLAG);
+        // the result going past 15 (or under 0) in the lower 4 bits, or past 255 (or under 0) in the whole byte
+        if (halfResult < 0 || halfResult > 0xF)
+            flags |= HALF_CARRY_FLAG;
 
-    return val;
+        if (result < 0 || result > 0xFF)
+            flags |= CARRY_FLAG;
+
+        table[index] = flags;
+    }
+
+    return table;
 }
 
-// general function for decrementing a byte (usually an 8-bit register) and checking to see if any flags should be set
-Byte CPU::decByte(Byte val)
+// builds the table of the flags that INC (or DEC, if decrement is true) sets for every value being incremented (or decremented).
+// the carry flag isn't touched by either of them, so it is never set in the table
+constexpr std::array<Byte, 0x100> makeIncrementFlagsTable(bool decrement)
 {
-    // check if any of the first 4 bits of the byte are set. if any of them are set, then decrementing will not cause a borrow of any kind
-    // if none of them are set, however, then decremting will borrow from the more significant digits, which means we need to set the half-carry flag
-    if (val & 0x0F)
-        mRegisters.maskFlag(HALF_CARRY_FLAG); // no borrowing
-    else
-        mRegisters.setFlag(HALF_CARRY_FLAG);  // borrowing
+    std::array<Byte, 0x100> table = {};
+
+    for (int val = 0; val < 0x100; val++)
+    {
+        Byte result = decrement ? val - 1 : val + 1;
+        Byte flags = decrement ? NEGATIVE_FLAG : 0;
+
+        if (result == 0)
+            flags |= ZERO_FLAG;
+
+        // incrementing from 0xF in the lower 4 bits carries out of them, and decrementing from 0x0 borrows into them
+        if ((val & 0xF) == (decrement ? 0x0 : 0xF))
+            flags |= HALF_CARRY_FLAG;
+
+        table[val] = flags;
+    }
+
+    return table;
+}
+
+// generated at compile time (and declared in Registers.h, as the JIT uses them as well). the arithmetic tables are 64 KB each, but
+// only the few pairs of values that a game actually uses are ever touched, so in practice they take up very little of the cache
+constexpr std::array<Byte, 0x10000> ADD_FLAGS = makeArithmeticFlagsTable(false);
+constexpr std::array<Byte, 0x10000> SUB_FLAGS = makeArithmeticFlagsTable(true);
+constexpr std::array<Byte, 0x100> INC_FLAGS = makeIncrementFlagsTable(false);
+constexpr std::array<Byte, 0x100> DEC_FLAGS = makeIncrementFlagsTable(true);
 
-    val--;
+// general function for incrementing a byte (usually an 8-bit register) and checking to see if any flags should be set
+Byte CPU::incByte(Byte val)
+{
+    // incrementing clears the subtraction flag, and never touches the carry flag
+    mState.registers.setFlags(ZERO_FLAG | NEGATIVE_FLAG | HALF_CARRY_FLAG, INC_FLAGS[val]);
 
-    if (val == 0)
-        mRegisters.setFlag(ZERO_FLAG);
-    else
-        mRegisters.maskFlag(ZERO_FLAG);
+    return val + 1;
+}
 
-    // set the subtraction flag (as decrementing is a subtraction)
-    mRegisters.setFlag(NEGATIVE_FLAG);
+// general function for decrementing a byte (usually an 8-bit register) and checking to see if any flags should be set
+Byte CPU::decByte(Byte val)
+{
+    // decrementing sets the subtraction flag, and never touches the carry flag
+    mState.registers.setFlags(ZERO_FLAG | NEGATIVE_FLAG | HALF_CARRY_FLAG, DEC_FLAGS[val]);
 
-    return val;
+    return val - 1;
 }
 
 // general function for adding two 16-bit registers together and checks for subtraction flag, half-carry flag, and carry flag
@@ -58,89 +136,46 @@ DoubleByte CPU::addW(DoubleByte a, DoubleByte b)
     // define result as 32 bit integer so that it can contain the potential overflow
     uint32_t result = a + b;
 
-    // if the 32 bit result of adding the two numbers together is greater than 0xFFFF, then it means an overflow would have occured in the 16-bit addition
-    if (result & 0xFFFF0000)
-        mRegisters.setFlag(CARRY_FLAG);
-    else
-        mRegisters.maskFlag(CARRY_FLAG);
-
-    // check for overflow of the first 4 bits of the second byte of each value involved in the addition
-    if ((a & 0xFFF) + (b & 0xFFF) > 0xFFF)
-        mRegisters.setFlag(HALF_CARRY_FLAG);
-    else
-        mRegisters.maskFlag(HALF_CARRY_FLAG);
-
     // clear the subtraction flag
-    mRegisters.maskFlag(NEGATIVE_FLAG);
+    mState.registers.maskFlag(NEGATIVE_FLAG);
 
-    return a + b;
+    // the half-carry flag is set by a carry out of bit 11, and the carry flag by a carry out of bit 15. shifting everything
+    // right by 8 lines those bits up with the ones used for 8-bit operations, so the flags can be worked out the same way
+    mState.registers.setLazyFlags(HALF_CARRY_FLAG | CARRY_FLAG, result >> 8, (a ^ b) >> 8);
+
+    return result;
 }
 
 // general function for adding two 8-bit registers together and checking for flags
 Byte CPU::addB(Byte a, Byte b)
 {
-    mRegisters.maskFlag(NEGATIVE_FLAG);
-
-    DoubleByte result = a + b;
-
-    // set the carry flag if a and b's addition would cause an overflow
-    if (result & 0xFF00) mRegisters.setFlag(CARRY_FLAG);
-    else                 mRegisters.maskFlag(CARRY_FLAG);
+    // every flag is looked up at once, using both values
+    mState.registers.setFlags(ALL_FLAGS, ADD_FLAGS[(a << 8) | b]);
 
-    // set the half carry flag if there is going to be a carry in the first 4 bits of the byte
-    if ((a & 0xF) + (b & 0xF) > 0xF) mRegisters.setFlag(HALF_CARRY_FLAG);
-    else                             mRegisters.maskFlag(HALF_CARRY_FLAG);
-
-    // set the zero flag if the result ends up being 0
-    if ((result & 0xFF) == 0) mRegisters.setFlag(ZERO_FLAG);
-    else            mRegisters.maskFlag(ZERO_FLAG);
-
-    return result & 0xFF;
+    return a + b;
 }
 
 // general function for adding a and b together as well as the carry flag
 void CPU::addBC(Byte val)
 {
-    mRegisters.maskFlag(NEGATIVE_FLAG);
-
-    Byte carry = mRegisters.isFlagSet(CARRY_FLAG);
-    DoubleByte result = mRegisters.A + val + carry;
-
-    // set the carry flag if a and b's addition would cause an overflow
-    if (result & 0xFF00) mRegisters.setFlag(CARRY_FLAG);
-    else                 mRegisters.maskFlag(CARRY_FLAG);
+    mState.registers.maskFlag(NEGATIVE_FLAG);
 
-    // set the half carry flag if there is going to be a carry in the first 4 bits of the byte
-    if (carry + (mRegisters.A & 0xF) + (val & 0xF) > 0xF) mRegisters.setFlag(HALF_CARRY_FLAG);
-    else                                                  mRegisters.maskFlag(HALF_CARRY_FLAG);
+    Byte carry = mState.registers.isFlagSet(CARRY_FLAG);
+    DoubleByte result = mState.registers.A + val + carry;
 
-    mRegisters.A += val + carry;
+    mState.registers.setLazyFlags(ZERO_FLAG | HALF_CARRY_FLAG | CARRY_FLAG, result, mState.registers.A ^ val);
 
-    // set the zero flag if the result ends up being 0
-    if (mRegisters.A == 0) mRegisters.setFlag(ZERO_FLAG);
-    else                   mRegisters.maskFlag(ZERO_FLAG);
+    mState.registers.A = result & 0xFF;
 }
 
 // general function for subtracting an 8-bit value from register A and checking for flags
 void CPU::sub(Byte val)
 {
-    // set the negative flag
-    mRegisters.setFlag(NEGATIVE_FLAG);
-
-    // if the subtraction would result in an overflow
-    if (val > mRegisters.A) mRegisters.setFlag(CARRY_FLAG);
-    else                    mRegisters.maskFlag(CARRY_FLAG);
-
-    // if the lower bits of the register would overflow
-    if ((val & 0xF) > (mRegisters.A & 0xF)) mRegisters.setFlag(HALF_CARRY_FLAG);
-    else                                    mRegisters.maskFlag(HALF_CARRY_FLAG);
+    // every flag is looked up at once, using A and the value being subtracted from it
+    mState.registers.setFlags(ALL_FLAGS, SUB_FLAGS[(mState.registers.A << 8) | val]);
 
     // subtract the value from register A
-    mRegisters.A -= val;
-
-    // set the zero flag if register A is now zero
-    if (mRegisters.A == 0) mRegisters.setFlag(ZERO_FLAG);
-    else                   mRegisters.maskFlag(ZERO_FLAG);
+    mState.registers.A -= val;
 }
 
 // general function for subtracting a (value PLUS the carry flag) from register A
@@ -148,79 +183,51 @@ void CPU::sub(Byte val)
 // in particular i couldn't find out why this implentation was working with the half flags but my own wasn't
 void CPU::sbc(Byte val)
 {
-    Byte carry = mRegisters.isFlagSet(CARRY_FLAG);
-    int result = mRegisters.A - val - carry;
-
-    mRegisters.setFlag(NEGATIVE_FLAG);
-
-    // if the subtraction would have resulted in a 0 (casting to a byte in case it became 0 by overflow)
-    if (((Byte)result) == 0) mRegisters.setFlag(ZERO_FLAG);
-    else mRegisters.maskFlag(ZERO_FLAG);
+    Byte carry = mState.registers.isFlagSet(CARRY_FLAG);
+    DoubleByte result = mState.registers.A - val - carry;
 
-    // if the result would have overflowed (i.e. if the subtraction would have caused the byte to wrap from 0 to 255)
-    if (result < 0) mRegisters.setFlag(CARRY_FLAG);
-    else            mRegisters.maskFlag(CARRY_FLAG);
+    mState.registers.setFlag(NEGATIVE_FLAG);
 
-    // if the first 4 bits of A - the first 4 bits of val - the carry bit is less than 0, then that means
-    // there would have been a borrow from the other bits of register A
-    if (((mRegisters.A & 0xF) - (val & 0xF) - carry) < 0) mRegisters.setFlag(HALF_CARRY_FLAG);
-    else                                                  mRegisters.maskFlag(HALF_CARRY_FLAG);
+    // a borrow out of the lower 4 bits or out of the whole byte shows up in the result the same way it does for sub
+    mState.registers.setLazyFlags(ZERO_FLAG | HALF_CARRY_FLAG | CARRY_FLAG, result, mState.registers.A ^ val);
 
-    mRegisters.A = (Byte)result;
+    mState.registers.A = result & 0xFF;
 }
 
 // general function for comparing register A against a value, and setting various flags based on the comparison
 void CPU::cp(Byte val)
 {
-    // set the negative flag
-    mRegisters.setFlag(NEGATIVE_FLAG);
-
-    // set or clear the zero flag
-    if (mRegisters.A == val) mRegisters.setFlag(ZERO_FLAG);
-    else                     mRegisters.maskFlag(ZERO_FLAG);
-
-    // set or clear the carry flag
-    if (val > mRegisters.A) mRegisters.setFlag(CARRY_FLAG);
-    else                    mRegisters.maskFlag(CARRY_FLAG);
-
-    // set or clear the half-carry flag
-    if ((((mRegisters.A & 0xF) - (val & 0xF)) & 0x10) == 0x10) mRegisters.setFlag(HALF_CARRY_FLAG);
-    else                                                       mRegisters.maskFlag(HALF_CARRY_FLAG);
+    // comparing is just a subtraction where the result is thrown away, so it sets the same flags
+    mState.registers.setFlags(ALL_FLAGS, SUB_FLAGS[(mState.registers.A << 8) | val]);
 }
 
 // general function for xoring a byte, setting all flags but the zero flag to 0. it only sets the zero flag if the result is zero
 void CPU::xorB(Byte val)
 {
-    mRegisters.maskFlag(CARRY_FLAG | HALF_CARRY_FLAG | NEGATIVE_FLAG);
+    mState.registers.maskFlag(CARRY_FLAG | HALF_CARRY_FLAG | NEGATIVE_FLAG);
 
-    if ((mRegisters.A ^ val)) mRegisters.maskFlag(ZERO_FLAG);
-    else         mRegisters.setFlag(ZERO_FLAG);
-
-    mRegisters.A ^= val;
+    mState.registers.A ^= val;
+    mState.registers.setLazyFlags(ZERO_FLAG, mState.registers.A, 0);
 }
 
 // general function for bitwise ORing a byte against register A
 void CPU::orB(Byte val)
 {
     // make all but the zero flags
-    mRegisters.maskFlag(NEGATIVE_FLAG | CARRY_FLAG | HALF_CARRY_FLAG);
-
-    mRegisters.A |= val;
+    mState.registers.maskFlag(NEGATIVE_FLAG | CARRY_FLAG | HALF_CARRY_FLAG);
 
-    if (mRegisters.A == 0) mRegisters.setFlag(ZERO_FLAG);
-    else                   mRegisters.maskFlag(ZERO_FLAG);
+    mState.registers.A |= val;
+    mState.registers.setLazyFlags(ZERO_FLAG, mState.registers.A, 0);
 }
 
 // general function for bitwise ANDing against register A
 void CPU::andB(Byte val)
 {
-    mRegisters.maskFlag(NEGATIVE_FLAG | CARRY_FLAG);
-    mRegisters.setFlag(HALF_CARRY_FLAG);
+    mState.registers.maskFlag(NEGATIVE_FLAG | CARRY_FLAG);
+    mState.registers.setFlag(HALF_CARRY_FLAG);
 
-    mRegisters.A &= val;
-    
-    if (mRegisters.A == 0) mRegisters.setFlag(ZERO_FLAG);
-    else                   mRegisters.maskFlag(ZERO_FLAG);
+    mState.registers.A &= val;
+    mState.registers.setLazyFlags(ZERO_FLAG, mState.registers.A, 0);
 }
 
 
@@ -228,1239 +235,856 @@ void CPU::andB(Byte val)
 void CPU::call(DoubleByte addr)
 {
     // push the current address onto the stack
-    mRegisters.sp -= 2;
-    mmu->writeDoubleByte(mRegisters.sp, mRegisters.pc);
+    mState.registers.sp -= 2;
+    mmu->writeStack(mState.registers.sp, mState.registers.pc);
 
     // set the program counter equal to the address at the start of the subroutine
-    mRegisters.pc = addr;
+    mState.registers.pc = addr;
 }
 
 // general function for returning from a function call
 void CPU::ret()
 {
-    mRegisters.pc = mmu->readDoubleByte(mRegisters.sp);
-    mRegisters.sp += 2;
+    mState.registers.pc = mmu->readStack(mState.registers.sp);
+    mState.registers.sp += 2;
 }
 
 // general function for pushing the value onto the stack
 void CPU::pushToStack(DoubleByte val) 
 {
-    mRegisters.sp -= 2;
-    mmu->writeDoubleByte(mRegisters.sp, val);
+    mState.registers.sp -= 2;
+    mmu->writeStack(mState.registers.sp, val);
 }
 
 // general function for popping the value from the top of the stack
 DoubleByte CPU::popFromStack()
 {
-    mRegisters.sp += 2;
-    return mmu->readDoubleByte(mRegisters.sp - 2);
+    mState.registers.sp += 2;
+    return mmu->readStack(mState.registers.sp - 2);
 }
 
-// decode the instruction
+// loads the register selected by bits 0-2 of the opcode into the register selected by bits 3-5
+template<Byte opcode>
+void CPU::loadRegister(CPU& cpu, DoubleByte operand)
+{
+    cpu.writeRegister<(opcode >> 3) & 7>(cpu.readRegister<opcode & 7>());
+}
+
+// applies the operation selected by bits 3-5 of the opcode (ADD, ADC, SUB, SBC, AND, XOR, OR or CP) to register A and the register selected by bits 0-2
+template<Byte opcode>
+void CPU::aluRegister(CPU& cpu, DoubleByte operand)
+{
+    constexpr Byte operation = (opcode >> 3) & 7;
+
+    Byte val = cpu.readRegister<opcode & 7>();
+
+    if constexpr (operation == 0)      cpu.mState.registers.A = cpu.addB(cpu.mState.registers.A, val);
+    else if constexpr (operation == 1) cpu.addBC(val);
+    else if constexpr (operation == 2) cpu.sub(val);
+    else if constexpr (operation == 3) cpu.sbc(val);
+    else if constexpr (operation == 4) cpu.andB(val);
+    else if constexpr (operation == 5) cpu.xorB(val);
+    else if constexpr (operation == 6) cpu.orB(val);
+    else                               cpu.cp(val);
+}
+
+// the opcode table. each entry holds the size of the opcode's operand, the number of ticks the opcode takes, and the handler that executes it
+// ticks taken from https://github.com/retrio/gb-test-roms/tree/master/instr_timing (a value of 0 means that the handler adds the
+// number of ticks itself, as it depends on whether a condition was met)
 // opcode table can be found here: https://www.pastraiser.com/cpu/gameboy/gameboy_opcodes.html
 // with lots of information on each opcode here: https://rgbds.gbdev.io/docs/v0.6.0/gbz80.7/
-void CPU::handleOpcodes(Byte opcode, DoubleByte operand)
+const CPU::Opcode CPU::OPCODES[256] =
 {
-    // because it is impossible for C++ to create variables in switch statements, this placeholder Double Byte must be declared outside of it 
-    DoubleByte placeHolderW;
+    // opcode 0x0, NOP: no operation (does nothing)
+    { 0, 4, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0x1, LD_BC_NN: loads NN into the register BC
+    { 2, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.BC = operand; } },
+
+    // opcode 0x2: LD_BC_A: set the address that BC is pointing to to A
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeByte(cpu.mState.registers.BC, cpu.mState.registers.A); } },
 
-    switch (opcode)
+    // opcode 0x3, INC_BC: increment register BC
+    { 0, 8, [](CPU& cpu, DoubleByte operand)
     {
-        // opcode 0x0, NOP: no operation (does nothing)
-        case 0x0: 
-            break;
-        
-        case 0x1: // opcode 0x1, LD_BC_NN: loads NN into the register BC
-            mRegisters.BC = operand;
-            break;
+        cpu.mState.registers.BC++; // note that for 16 bit registers, we don't set or clear any flags when incrementing
+    } },
 
-        case 0x2: // opcode 0x2: LD_BC_A: set the address that BC is pointing to to A
-            mmu->writeByte(mRegisters.BC, mRegisters.A);
-            break;
+    // opcode 0x4, INC_B: increment register B
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.B = cpu.incByte(cpu.mState.registers.B); } },
 
-        case 0x3: // opcode 0x3, INC_BC: increment register BC  
-            mRegisters.BC++; // note that for 16 bit registers, we don't set or clear any flags when incrementing
-            break;
-        
-        case 0x4: // opcode 0x4, INC_B: increment register B
-            mRegisters.B = incByte(mRegisters.B);
-            break;
-
-        case 0x5: // opcode 0x5, DEC_B: decrement register B
-            mRegisters.B = decByte(mRegisters.B);
-            break;
-
-        case 0x6: // opcode 0x6, LD_B_N: load N into register B
-            mRegisters.B = (Byte)operand;
-            break;
-
-        case 0x7: // opcode 0x7, RLC_A: rotate register A left once, and set the carry flag if there was a wrap
-            mRegisters.A = rlc(mRegisters.A);
-            mRegisters.maskFlag(ZERO_FLAG);
-            break;
-
-        case 0x8: // opcode 0x8, LD_NN_SP: store the stack pointer's value at memory address NN
-            mmu->writeDoubleByte(operand, mRegisters.sp);
-            break;
-
-        case 0x9: // opcode 0x9, ADD_HL_BC: add register BC to register HL
-            mRegisters.HL = addW(mRegisters.HL, mRegisters.BC);
-            break;
-
-        case 0xA: // opcode 0xA, LD_A_BC: load the value that BC is pointing to into register A
-            mRegisters.A = mmu->readByte(mRegisters.BC);
-            break;
-
-        case 0xB: // opcode 0xB, DEC_BC: decrement the 16-bit register BC
-            mRegisters.BC--; // 16-bit registers don't require checking for flags when decrementing
-            break;
-
-        case 0xC: // opcode 0xC, INC_C: increment the register C
-            mRegisters.C = incByte(mRegisters.C);
-            break;
-
-        case 0xD: // opcode 0xD, DEC_C: decrement the register C
-            mRegisters.C = decByte(mRegisters.C);
-            break;
-
-        case 0xE: // opcode 0xE, LD_C_N: load N into register C
-            mRegisters.C = (Byte)operand;
-            break;
-
-        case 0xF: // opcode 0xF, RLC_A: rotate register A right once, and set the carry flag if there was a wrap
-            mRegisters.A = rrc(mRegisters.A);
-            mRegisters.maskFlag(ZERO_FLAG);
-            break;
-
-        case 0x10: // opcode 0x10, STOP
-            // although this has some specific functions, for the purposes of this emulator, it is okay to just skip the STOP instruction
-            // of the games tested, it has never found to be a problem, and with all blargg tests passing, this implentation is acceptable
-            break;
-
-        case 0x11: // opcode 0x11, LD_DE_NN: load the value NN into register DE
-            mRegisters.DE = operand;
-            break;
-
-        case 0x12: // opcode 0x12, LD_DE_A: store the value of register A into the memory address pointed to by register DE
-            mmu->writeByte(mRegisters.DE, mRegisters.A);
-            break;
-
-        case 0x13: // opcode 0x13, INC_DE: increment 16-bit register DE
-            mRegisters.DE++;
-            break;
-
-        case 0x14: // opcode 0x14, IND_C: increment register D
-            mRegisters.D = incByte(mRegisters.D);
-            break;
-
-        case 0x15: // opcode 0x15, DEC_D: decrement register D
-            mRegisters.D = decByte(mRegisters.D);
-            break;
-
-        case 0x16: // opcode 0x16, LD_D_N: set register D to N
-            mRegisters.D = (Byte)operand;
-            break;
-
-        case 0x17: // opcode 0x17, RL_A: rotate A left, WITHOUT checking for the carry flag
-            mRegisters.A = rl(mRegisters.A);
-            mRegisters.maskFlag(ZERO_FLAG);
-            break;
-
-        case 0x18: // opcode 0x18, JR_N: jump, relative to the current memory address, to the memory address N (which is a signed integer!)
-            mRegisters.pc += (Signedbyte)operand;
-            break;
-
-        case 0x19: // opcode 0x19, ADD_HL_DE: add register DE to register HL
-            mRegisters.HL = addW(mRegisters.HL, mRegisters.DE);
-            break;
-
-        case 0x1A: // opcode 0x1A, LD_A_(DE): store the value pointed to by DE into register A
-            mRegisters.A = mmu->readByte(mRegisters.DE);
-            break;
-
-        case 0x1B: // opcode 0x1B, DEC_DE: decrement register DE
-            mRegisters.DE--;
-            break;
-        
-        case 0x1C: // opcode 0x1C, INC_E: increment register E
-            mRegisters.E = incByte(mRegisters.E);
-            break;
-
-        case 0x1D: // opcode 0x1D, DEC_E: decrement register E
-            mRegisters.E = decByte(mRegisters.E);
-            break;
-            
-        case 0x1E: // opcode 0x1E, LD_E_N: load the value of N into register E
-            mRegisters.E = (Byte)operand;
-            break;
-
-        case 0x1F: // opcode 0x1F, RR_A: rotate register A right once, rotating through the carry
-            mRegisters.A = rr(mRegisters.A);
-            mRegisters.maskFlag(ZERO_FLAG);
-            break;
-        
-        case 0x20: // opcode 0x20: JR_NZ_N: if the last result was not zero, then jump signed N bytes ahead in memory
-            if (!mRegisters.isFlagSet(ZERO_FLAG))
-            {
-                mRegisters.pc += (Signedbyte)operand;
-                mTicks += 12;
-            }
-            else
-                mTicks += 8;
-
-            break;
-
-        case 0x21: // opcode 0x21, LD_HL_NN: load the value of NN into register HL
-            mRegisters.HL = operand;
-            break;
-
-        case 0x22: // opcode 0x22, LDI_HL_A: store the value of Register A into the memory address pointed to by HL, and then increment HL
-            mmu->writeByte(mRegisters.HL, mRegisters.A);
-            mRegisters.HL++;
-            break;
-
-        case 0x23: // opcode 0x23, INC_HL: increment register HL
-            mRegisters.HL++;
-            break;
-
-        case 0x24: // opcode 0x24, INC_H: increment register H
-            mRegisters.H = incByte(mRegisters.H);
-            break;
-        
-        case 0x25: // opcode 0x25, DEC_H, decrement register H
-            mRegisters.H = decByte(mRegisters.H);
-            break;
-
-        case 0x26: // opcode 0x26, LD_H_N: load the value of N into register H
-            mRegisters.H = (Byte)operand;
-            break;
-
-        case 0x27: // opcode 0x27, DAA: adjust register A so that the BCD (binary coded decimal) representation is accurate after an arithmetic operation has occurred
-            placeHolderW = mRegisters.A;
-
-            if (mRegisters.isFlagSet(NEGATIVE_FLAG))
-            {
-                if (mRegisters.isFlagSet(HALF_CARRY_FLAG))
-                    placeHolderW = (placeHolderW - 0x06) & 0xFF;
-
-                if (mRegisters.isFlagSet(CARRY_FLAG))
-                    placeHolderW -= 0x60;
-            }
-            else
-            {
-                if (mRegisters.isFlagSet(HALF_CARRY_FLAG) || ((placeHolderW & 0xF) > 9))
-                    placeHolderW += 0x6;
-                
-                if (mRegisters.isFlagSet(CARRY_FLAG) || (placeHolderW > 0x9F))
-                    placeHolderW += 0x60;
-            }
-
-            // set register A to its now altered value
-            mRegisters.A = placeHolderW;
-            mRegisters.maskFlag(HALF_CARRY_FLAG);
-
-            if (mRegisters.A == 0)
-                mRegisters.setFlag(ZERO_FLAG);
-            else
-                mRegisters.maskFlag(ZERO_FLAG);
-
-            if ((placeHolderW & 0x100) == 0x100)
-                mRegisters.setFlag(CARRY_FLAG);
-
-            break;
-
-        case 0x28: // opcode 0x28 JR_Z_N, jump to the relative address of N (which is a signed integer! could mean we jump backwards) if the last operation resulted in a zero
-            if (mRegisters.isFlagSet(ZERO_FLAG))
-            {
-                mRegisters.pc += (Signedbyte)operand;
-                mTicks += 12;
-            }
-            else
-                mTicks += 8;
-
-            break;
-
-        case 0x29: // opcode 0x29, ADD_HL_HL: add HL to itself (times it by 2)
-            mRegisters.HL = addW(mRegisters.HL, mRegisters.HL);
-            break;
-
-        case 0x2A: // opcode 0x2A, LDI_A_HL: load the value stored in memory that is pointed to by HL into register A, then increment HL
-            mRegisters.A = mmu->readByte(mRegisters.HL);
-            mRegisters.HL++;
-            break;
-
-        case 0x2B: // opcode 0x2B, DEC_HL: decrement register HL
-            mRegisters.HL--;
-            break;
-
-        case 0x2C: // opcode 0x2C, INC_L: increment register L
-            mRegisters.L = incByte(mRegisters.L);
-            break;
-
-        case 0x2D: // opcode 0x2D, DEC_L: decrement register L
-            mRegisters.L = decByte(mRegisters.L);
-            break;
-        
-        case 0x2E: // opcode 0x2E, LD_L_N: load the value of N into register L
-            mRegisters.L = (Byte)operand;
-            break;
-
-        case 0x2F: // opcode 0x2F, CPL: logical not register A
-            mRegisters.A = ~mRegisters.A;
-            mRegisters.setFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
-            break;
-
-        case 0x30: // opcode 0x30, JR_NC_N: relative jump to signed N if the last instruction resulted in no carry
-            if (!mRegisters.isFlagSet(CARRY_FLAG))
-            {
-                mRegisters.pc += (Signedbyte)operand;
-                mTicks += 12;
-            }
-            else
-                mTicks += 8;
-
-            break;
-
-        case 0x31: // opcode 0x31, LD_SP_NN: set the stack pointer equal to NN
-            mRegisters.sp = operand;
-            break;
-
-        case 0x32: // opcode 0x32, LDD_HL_A: save the value of register A into the memory address pointed to by HL, and then decrement HL
-            mmu->writeByte(mRegisters.HL, mRegisters.A);
-            mRegisters.HL--;
-            break;
-
-        case 0x33: // opcode 0x33, INC_SP: increment the stack pointer
-            mRegisters.sp++;
-            break;
-
-        case 0x34: // opcode 0x34, INC_(HL): increment the value that HL is pointed at
-            mmu->writeByte(mRegisters.HL, incByte(mmu->readByte(mRegisters.HL)));
-            break;
-
-        case 0x35: // opcode 0x35, DEC_(HL): decrement the value that HL is pointed at
-            mmu->writeByte(mRegisters.HL, decByte(mmu->readByte(mRegisters.HL)));
-            break;
-
-        case 0x36: // opcode 0x36, LD_(HL)_N: load the value of N into the memory address that HL is pointed at
-            mmu->writeByte(mRegisters.HL, (Byte)operand);
-            break;
-
-        case 0x37: // opcode 0x37, SCF: set the carry flag (and clear the negative and half carry flags)
-            mRegisters.setFlag(CARRY_FLAG);
-            mRegisters.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
-            break;
-
-        case 0x38: // opcode 0x38, JR_C_N: relative jump by signed N, if the last result resulted in the carry flag being set
-            if (mRegisters.isFlagSet(CARRY_FLAG))
-            {
-                mRegisters.pc += (Signedbyte)operand;
-                mTicks += 12;
-            }
-            else
-                mTicks += 8;
-
-            break;
-
-        case 0x39: // opcode 0x39, ADD_HL_SP: add the value of the stack pointer to HL
-            mRegisters.HL = addW(mRegisters.HL, mRegisters.sp);
-            break;
-
-        case 0x3A: // opcode 0x3A, LDD_A_(HL): load the value of the memory address pointed to by HL into register A, and then decrement HL
-            mRegisters.A = mmu->readByte(mRegisters.HL);
-            mRegisters.HL--;
-            break;
-
-        case 0x3B: // opcode 0x3B, DEC_SP: decrement the stack pointer
-            mRegisters.sp--;
-            break;
-
-        case 0x3C: // opcode 0x3C, INC_A: increment the register A
-            mRegisters.A = incByte(mRegisters.A);
-            break;
-
-        case 0x3D: // opcode 0x3D, DEC_A: decrement the register A
-            mRegisters.A = decByte(mRegisters.A);
-            break;
-
-        case 0x3E: // opcode 0x3E, LD_A_N: load the value of N into register A
-            mRegisters.A = (Byte)operand;
-            break;
-        
-        case 0x3F: // opcode 0x3F, CCF: flip the carry flag and clear the negative and half carry flags
-            if (mRegisters.isFlagSet(CARRY_FLAG))
-                mRegisters.maskFlag(CARRY_FLAG);
-            else
-                mRegisters.setFlag(CARRY_FLAG);
+    // opcode 0x5, DEC_B: decrement register B
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.B = cpu.decByte(cpu.mState.registers.B); } },
+
+    // opcode 0x6, LD_B_N: load N into register B
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.B = (Byte)operand; } },
+
+    // opcode 0x7, RLC_A: rotate register A left once, and set the carry flag if there was a wrap
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.A = cpu.rlc(cpu.mState.registers.A);
+        cpu.mState.registers.maskFlag(ZERO_FLAG);
+    } },
+
+    // opcode 0x8, LD_NN_SP: store the stack pointer's value at memory address NN
+    { 2, 20, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeDoubleByte(operand, cpu.mState.registers.sp); } },
+
+    // opcode 0x9, ADD_HL_BC: add register BC to register HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.HL = cpu.addW(cpu.mState.registers.HL, cpu.mState.registers.BC); } },
 
-            mRegisters.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
-            break;
+    // opcode 0xA, LD_A_BC: load the value that BC is pointing to into register A
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = cpu.mmu->readByte(cpu.mState.registers.BC); } },
 
-        case 0x40: // opcode 0x40, LD_B_B: load the value of B into B (?)
-            break;
+    // opcode 0xB, DEC_BC: decrement the 16-bit register BC
+    { 0, 8, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.BC--; // 16-bit registers don't require checking for flags when decrementing
+    } },
 
-        case 0x41: // opcode 0x41, LD_B_C: load the value of C into B
-            mRegisters.B = mRegisters.C;
-            break;
+    // opcode 0xC, INC_C: increment the register C
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.C = cpu.incByte(cpu.mState.registers.C); } },
 
-        case 0x42: // opcode 0x42, LD_B_D: load the value of D into B
-            mRegisters.B = mRegisters.D;
-            break;
+    // opcode 0xD, DEC_C: decrement the register C
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.C = cpu.decByte(cpu.mState.registers.C); } },
 
-        case 0x43: // opcode 0x43, LD_B_E: load the value of E into B
-            mRegisters.B = mRegisters.E;
-            break;
+    // opcode 0xE, LD_C_N: load N into register C
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.C = (Byte)operand; } },
 
-        case 0x44: // opcode 0x44, LD_B_H: load the value of H into B
-            mRegisters.B = mRegisters.H;
-            break;
+    // opcode 0xF, RLC_A: rotate register A right once, and set the carry flag if there was a wrap
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.A = cpu.rrc(cpu.mState.registers.A);
+        cpu.mState.registers.maskFlag(ZERO_FLAG);
+    } },
 
-        case 0x45: // opcode 0x45, LD_B_L: load the value of L into B
-            mRegisters.B = mRegisters.L;
-            break;
+    // opcode 0x10, STOP
+    { 1, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        // although this has some specific functions, for the purposes of this emulator, it is okay to just skip the STOP instruction
+        // of the games tested, it has never found to be a problem, and with all blargg tests passing, this implentation is acceptable
+    } },
 
-        case 0x46: // opcode 0x46, LD_B_(HL); load the value in memory pointed to by HL into register B
-            mRegisters.B = mmu->readByte(mRegisters.HL);
-            break;
+    // opcode 0x11, LD_DE_NN: load the value NN into register DE
+    { 2, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.DE = operand; } },
 
-        case 0x47: // opcode 0x47, LD_B_A: load the value of register A into register B
-            mRegisters.B = mRegisters.A;
-            break;
+    // opcode 0x12, LD_DE_A: store the value of register A into the memory address pointed to by register DE
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeByte(cpu.mState.registers.DE, cpu.mState.registers.A); } },
 
-        case 0x48: // opcode 0x48, LD_C_B: load the value of B into C
-            mRegisters.C = mRegisters.B;
-            break;
+    // opcode 0x13, INC_DE: increment 16-bit register DE
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.DE++; } },
 
-        case 0x49: // opcode 0x49, LD_C_C: load the value of C into C (do nothing)
-            break;
+    // opcode 0x14, IND_C: increment register D
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.D = cpu.incByte(cpu.mState.registers.D); } },
 
-        case 0x4A: // opcode 0x4A, LD_C_D: load the value of D into C
-            mRegisters.C = mRegisters.D;
-            break;
+    // opcode 0x15, DEC_D: decrement register D
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.D = cpu.decByte(cpu.mState.registers.D); } },
 
-        case 0x4B: // opcode 0x4B, LD_C_E: load the value of E into C
-            mRegisters.C = mRegisters.E;
-            break;
+    // opcode 0x16, LD_D_N: set register D to N
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.D = (Byte)operand; } },
 
-        case 0x4C: // opcode 0x4C, LD_C_H: load the value of H into C
-            mRegisters.C = mRegisters.H;
-            break;
+    // opcode 0x17, RL_A: rotate A left, WITHOUT checking for the carry flag
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.A = cpu.rl(cpu.mState.registers.A);
+        cpu.mState.registers.maskFlag(ZERO_FLAG);
+    } },
 
-        case 0x4D: // opcode 0x4D, LD_C_L: load the value of L into C
-            mRegisters.C = mRegisters.L;
-            break;
+    // opcode 0x18, JR_N: jump, relative to the current memory address, to the memory address N (which is a signed integer!)
+    { 1, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.pc += (Signedbyte)operand; } },
 
-        case 0x4E: // opcode 0x4E, LD_C_(HL): load the value in memory pointed to by HL into register C
-            mRegisters.C = mmu->readByte(mRegisters.HL);
-            break;
+    // opcode 0x19, ADD_HL_DE: add register DE to register HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.HL = cpu.addW(cpu.mState.registers.HL, cpu.mState.registers.DE); } },
 
-        case 0x4F: // opcode 0x4F, LD_C_A: load the value of register A into register C
-            mRegisters.C = mRegisters.A;
-            break;
+    // opcode 0x1A, LD_A_(DE): store the value pointed to by DE into register A
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = cpu.mmu->readByte(cpu.mState.registers.DE); } },
 
-        case 0x50: // opcode 0x50, LD_D_B: load the value of B into D
-            mRegisters.D = mRegisters.B;
-            break;
+    // opcode 0x1B, DEC_DE: decrement register DE
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.DE--; } },
 
-        case 0x51: // opcode 0x51, LD_D_C: load the value of C into D
-            mRegisters.D = mRegisters.C;
-            break;
+    // opcode 0x1C, INC_E: increment register E
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.E = cpu.incByte(cpu.mState.registers.E); } },
 
-        case 0x52: // opcode 0x52, LD_D_D: load the value of D into D (do nothing)
-            break;
+    // opcode 0x1D, DEC_E: decrement register E
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.E = cpu.decByte(cpu.mState.registers.E); } },
 
-        case 0x53: // opcode 0x53, LD_D_E: load the value of E into D
-            mRegisters.D = mRegisters.E;
-            break;
+    // opcode 0x1E, LD_E_N: load the value of N into register E
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.E = (Byte)operand; } },
 
-        case 0x54: // opcode 0x54, LD_D_H: load the value of register H into register D
-            mRegisters.D = mRegisters.H;
-            break;
+    // opcode 0x1F, RR_A: rotate register A right once, rotating through the carry
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.A = cpu.rr(cpu.mState.registers.A);
+        cpu.mState.registers.maskFlag(ZERO_FLAG);
+    } },
 
-        case 0x55: // opcode 0x55, LD_D_L: load the value of L into D
-            mRegisters.D = mRegisters.L;
-            break;
+    // opcode 0x20: JR_NZ_N: if the last result was not zero, then jump signed N bytes ahead in memory
+    { 1, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (!cpu.mState.registers.isFlagSet(ZERO_FLAG))
+        {
+            cpu.mState.registers.pc += (Signedbyte)operand;
+            cpu.mState.ticks += 12;
+        }
+        else
+            cpu.mState.ticks += 8;
+    } },
+
+    // opcode 0x21, LD_HL_NN: load the value of NN into register HL
+    { 2, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.HL = operand; } },
+
+    // opcode 0x22, LDI_HL_A: store the value of Register A into the memory address pointed to by HL, and then increment HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mmu->writeByte(cpu.mState.registers.HL, cpu.mState.registers.A);
+        cpu.mState.registers.HL++;
+    } },
 
-        case 0x56: // opcode 0x56, LD_D_(HL): load the value stored at the address pointed to by HL into register D
-            mRegisters.D = mmu->readByte(mRegisters.HL);
-            break;
+    // opcode 0x23, INC_HL: increment register HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.HL++; } },
 
-        case 0x57: // opcode 0x57, LD_D_A: load the value of register A into register D
-            mRegisters.D = mRegisters.A;
-            break;
+    // opcode 0x24, INC_H: increment register H
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.H = cpu.incByte(cpu.mState.registers.H); } },
 
-        case 0x58: // opcode 0x58, LD_E_B: load the value of B into E
-            mRegisters.E = mRegisters.B;
-            break;
+    // opcode 0x25, DEC_H, decrement register H
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.H = cpu.decByte(cpu.mState.registers.H); } },
 
-        case 0x59: // opcode 0x59, LD_E_C: load the value of C into E
-            mRegisters.E = mRegisters.C;
-            break;
+    // opcode 0x26, LD_H_N: load the value of N into register H
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.H = (Byte)operand; } },
 
-        case 0x5A: // opcode 0x5A, LD_E_D: load the value of register D into register E
-            mRegisters.E = mRegisters.D;
-            break;
+    // opcode 0x27, DAA: adjust register A so that the BCD (binary coded decimal) representation is accurate after an arithmetic operation has occurred
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.resolveFlags();
 
-        case 0x5B: // opcode 0x5B, LD_E_E: load the value of E into E (do nothing)
-            break;
+        // look up the adjusted value of A and the new flags using the current N, H and C flags
+        DoubleByte adjusted = DAA_TABLE[(((cpu.mState.registers.F >> 4) & 0x7) << 8) | cpu.mState.registers.A];
 
-        case 0x5C: // opcode 0x5C, LD_E_H: load the value of H into E
-            mRegisters.E = mRegisters.H;
-            break;
+        // set register A to its now altered value
+        cpu.mState.registers.A = adjusted & 0xFF;
+        cpu.mState.registers.F = (cpu.mState.registers.F & 0xF) | (adjusted >> 8);
+    } },
 
-        case 0x5D: // opcode 0x5D, LD_E_L: load the value of L into register E
-            mRegisters.E = mRegisters.L;
-            break;
+    // opcode 0x28 JR_Z_N, jump to the relative address of N (which is a signed integer! could mean we jump backwards) if the last operation resulted in a zero
+    { 1, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(ZERO_FLAG))
+        {
+            cpu.mState.registers.pc += (Signedbyte)operand;
+            cpu.mState.ticks += 12;
+        }
+        else
+            cpu.mState.ticks += 8;
+    } },
+
+    // opcode 0x29, ADD_HL_HL: add HL to itself (times it by 2)
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.HL = cpu.addW(cpu.mState.registers.HL, cpu.mState.registers.HL); } },
+
+    // opcode 0x2A, LDI_A_HL: load the value stored in memory that is pointed to by HL into register A, then increment HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.A = cpu.mmu->readByte(cpu.mState.registers.HL);
+        cpu.mState.registers.HL++;
+    } },
 
-        case 0x5E: // opcode 0x5E, LD_E_(HL): load the value stored at the address pointed to by HL into register A
-            mRegisters.E = mmu->readByte(mRegisters.HL);
-            break;
-
-        case 0x5F: // opcode 0x5F, LD_E_A: store the value of register A into register E
-            mRegisters.E = mRegisters.A;
-            break;
-
-        case 0x60: // opcode 0x60, LD_H_B: load the value of B into register H
-            mRegisters.H = mRegisters.B;
-            break;
-
-        case 0x61: // opcode 0x61, LD_H_C: load the value of C into H
-            mRegisters.H = mRegisters.C;
-            break;
-
-        case 0x62: // opcode 0x62, LD_H_D: load the value of register D into register H
-            mRegisters.H = mRegisters.D;
-            break;
-
-        case 0x63: // opcode 0x63, LD_H_E: load the value of E into H
-            mRegisters.H = mRegisters.E;
-            break;
-
-        case 0x64: // opcode 0x64, LD_H_H: load the value of H into H (do nothing)
-            break;
-
-        case 0x65: // opcode 0x65, LD_H_L: load the value of register L into register H
-            mRegisters.H = mRegisters.L;
-            break;
-
-        case 0x66: // opcode 0x66, LD_H_(HL): load what HL is pointed at in memory to H
-            mRegisters.H = mmu->readByte(mRegisters.HL);
-            break;
-
-        case 0x67: // opcode 0x67, LD_H_A: load the value of register A into register H
-            mRegisters.H = mRegisters.A;
-            break;
-
-        case 0x68: // opcode 0x68, LD_L_B: load the value of B into L
-            mRegisters.L = mRegisters.B;
-            break;
-
-        case 0x69: // opcode 0x69, LD_L_C: load the value of register C into register L
-            mRegisters.L = mRegisters.C;
-            break;
-
-        case 0x6A: // opcode 0x6A, LD_L_D: load the value of D into L
-            mRegisters.L = mRegisters.D;
-            break;
-
-        case 0x6B: // opcode 0x6B, LD_L_E: load the value of register E into register L
-            mRegisters.L = mRegisters.E;
-            break;
-
-        case 0x6C: // opcode 0x6C, LD_L_H: load the value of H into L
-            mRegisters.L = mRegisters.H;
-            break;
-
-        case 0x6D: // opcode 0x6D, LD_L_L: load the value of L into L (do nothing)
-            break;
-
-        case 0x6E: // opcode 0x6E, LD_L_(HL): load the value pointed to in memory by HL into L
-            mRegisters.L = mmu->readByte(mRegisters.HL);
-            break;
-
-        case 0x6F: // opcode 0x6F, LD_L_A: load the value of register A into register L
-            mRegisters.L = mRegisters.A;
-            break;
-
-        case 0x70: // opcode 0x70, LD_(HL)_B: store the value of register B into the memory address pointed to by HL
-            mmu->writeByte(mRegisters.HL, mRegisters.B);
-            break;
-
-        case 0x71: // opcode 0x71, LD_(HL)_C: store the value of register C into the memory address pointed to by HL
-            mmu->writeByte(mRegisters.HL, mRegisters.C);
-            break;
-
-        case 0x72: // opcode 0x72, LD_(HL)_D: store the value of register D into the memory address pointed to by HL
-            mmu->writeByte(mRegisters.HL, mRegisters.D);
-            break;
-
-        case 0x73: // opcode 0x73, LD_(HL)_E: load the value of register E into the memory address pointed to by register HL
-            mmu->writeByte(mRegisters.HL, mRegisters.E);
-            break;
-
-        case 0x74: // opcode 0x74, LD_(HL)_H: load the value of H into the memory address pointed to be HL
-            mmu->writeByte(mRegisters.HL, mRegisters.H);
-            break;
-
-        case 0x75: // opcode 0x75, LD_(HL)_L: load the value of L into the memory address pointed to be HL
-            mmu->writeByte(mRegisters.HL, mRegisters.L);
-            break;
-
-        case 0x76: // opcode 0x76, HALT: stop exeuction until an interrupt occurs
-            if (mmu->readByte(INTERRUPTS_FLAGS_OFFSET) & mmu->readByte(INTERRUPTS_ENABLED_OFFSET))
-                mRegisters.pc++;
-            else
-                // we decrement the pc here because we automatically increment it after fetching the opcode
-                // but, when the CPU is in a halted state, we want to stay at the exact same HALT opcode
-                // until an interrupt has occured
-                mRegisters.pc--;
-                
-            break;
-
-        case 0x77: // opcode 0x77 LD_(HL)_A: store the value of register A into the memory address pointed to by register HL
-            mmu->writeByte(mRegisters.HL, mRegisters.A);
-            break;
-
-        case 0x78: // opcode 0x78, LD_A_B: store the value of register B into register A
-            mRegisters.A = mRegisters.B;
-            break;
-
-        case 0x79: // opcode 0x79, LD_A_C: load the value of register C into register A
-            mRegisters.A = mRegisters.C;
-            break;
-
-        case 0x7A: // opcode 0x7A, LD_A_D: load the value of register D into register A
-            mRegisters.A = mRegisters.D;
-            break;
-
-        case 0x7B: // opcode 0x7B, LD_A_E: load the value of register E into register A
-            mRegisters.A = mRegisters.E;
-            break;
-
-        case 0x7C: // opcode 0x7C, LD_A_H: load the value of register H into register A
-            mRegisters.A = mRegisters.H;
-            break;
-
-        case 0x7D: // opcode 0x7D, LD_A_L: load the value of register L into register A
-            mRegisters.A = mRegisters.L;
-            break;
-
-        case 0x7E: // opcode 0x7E, LD_A_(HL): load the value pointed to in memory by HL into register A
-            mRegisters.A = mmu->readByte(mRegisters.HL);
-            break;
-
-        case 0x7F: // opcode 0x7F, LD_A_A: load A into A (do nothing)
-            break;
-
-        case 0x80: // opcode 0x80, ADD_A_B: add register B to register A
-            mRegisters.A = addB(mRegisters.A, mRegisters.B);
-            break;
-
-        case 0x81: // opcode 0x81, ADD_A_C: add register C to register A
-            mRegisters.A = addB(mRegisters.A, mRegisters.C);
-            break;
-
-        case 0x82: // opcode 0x82, ADD_A_D: add register D to register A
-            mRegisters.A = addB(mRegisters.A, mRegisters.D);
-            break;
-
-        case 0x83: // opcode 0x83, ADD_A_E: add register E to register A
-            mRegisters.A = addB(mRegisters.A, mRegisters.E);
-            break;
-
-        case 0x84: // opcode 0x84, ADD_A_H: add H to A
-            mRegisters.A = addB(mRegisters.A, mRegisters.H);
-            break;
-
-        case 0x85: // opcode 0x85, ADD_A_L: add register L to register A
-            mRegisters.A = addB(mRegisters.A, mRegisters.L);
-            break;
-
-        case 0x86: // opcode 0x86, ADD_A_(HL): add the value stored in Register A to the value pointed to by HL
-            mRegisters.A = addB(mRegisters.A, mmu->readByte(mRegisters.HL));
-            break;
-
-        case 0x87: // opcode 0x87, ADD_A_A: add the value of register A to register A
-            mRegisters.A = addB(mRegisters.A, mRegisters.A);
-            break;
-
-        case 0x88: // opcode 0x88, ADC_A_B: add register B and the carry flag to register A
-            addBC(mRegisters.B);
-            break;
-
-        case 0x89: // opcode 0x89, ADC_A_C: add register C and the carry flag to register A
-            addBC(mRegisters.C);
-            break;
-
-        case 0x8A: // opcode 0x8A, ADC_A_D: add register D and the carry flag to register A
-            addBC(mRegisters.D);
-            break;
-
-        case 0x8B: // opcode 0x8B, ADC_A_E: add register E and the carry flag to register A
-            addBC(mRegisters.E);
-            break;
-
-        case 0x8C: // opcode 0x8C, ADC_A_H: add register H and the carry flag to register A
-            addBC(mRegisters.H);
-            break;
-
-        case 0x8D: // opcode 0x8D, ADC_A_L: add register L and the carry flag to register A
-            addBC(mRegisters.L);
-            break;
-
-        case 0x8E: // opcode 0x8E, ADC_A_(HL) add the value pointed to in memory by HL and the carry flag to register A
-            addBC(mmu->readByte(mRegisters.HL));
-            break;
-
-        case 0x8F: // opcode 0x8F, ADC_A_A: add register A and the carry flag to register A
-            addBC(mRegisters.A);
-            break;
+    // opcode 0x2B, DEC_HL: decrement register HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.HL--; } },
 
-        case 0x90: // opcode 0x90, SUB_A_B: subtract the value of register B from register A
-            sub(mRegisters.B);
-            break;
+    // opcode 0x2C, INC_L: increment register L
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.L = cpu.incByte(cpu.mState.registers.L); } },
 
-        case 0x91: // opcode 0x91, SUB_A_C: subtract C from A
-            sub(mRegisters.C);
-            break;
+    // opcode 0x2D, DEC_L: decrement register L
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.L = cpu.decByte(cpu.mState.registers.L); } },
 
-        case 0x92: // opcode 0x92, SUB_A_D: subtract D from A
-            sub(mRegisters.D);
-            break;
+    // opcode 0x2E, LD_L_N: load the value of N into register L
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.L = (Byte)operand; } },
 
-        case 0x93: // opcode 0x93, SUB_A_E: subtract E from A
-            sub(mRegisters.E);
-            break;
+    // opcode 0x2F, CPL: logical not register A
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.A = ~cpu.mState.registers.A;
+        cpu.mState.registers.setFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+    } },
 
-        case 0x94: // opcode 0x94, SUB_A_H: subtract H from A
-            sub(mRegisters.H);
-            break;
+    // opcode 0x30, JR_NC_N: relative jump to signed N if the last instruction resulted in no carry
+    { 1, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (!cpu.mState.registers.isFlagSet(CARRY_FLAG))
+        {
+            cpu.mState.registers.pc += (Signedbyte)operand;
+            cpu.mState.ticks += 12;
+        }
+        else
+            cpu.mState.ticks += 8;
+    } },
+
+    // opcode 0x31, LD_SP_NN: set the stack pointer equal to NN
+    { 2, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.sp = operand; } },
+
+    // opcode 0x32, LDD_HL_A: save the value of register A into the memory address pointed to by HL, and then decrement HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mmu->writeByte(cpu.mState.registers.HL, cpu.mState.registers.A);
+        cpu.mState.registers.HL--;
+    } },
 
-        case 0x95: // opcode 0x95, SUB_A_L: subtract L from A
-            sub(mRegisters.L);
-            break;
+    // opcode 0x33, INC_SP: increment the stack pointer
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.sp++; } },
 
-        case 0x96: // opcode 0x96, SUB_A_(HL): subtract the value in memory pointed to by HL from A
-            sub(mmu->readByte(mRegisters.HL));
-            break;
-
-        case 0x97: // opcode 0x97, SUB_A_A: subtract A from A
-            sub(mRegisters.A);
-            break;
-
-        case 0x98: // opcode 0x98, SBC_A_B: subtract register B and the carry from register A
-            sbc(mRegisters.B);
-            break;
-
-        case 0x99: // opcode 0x99, SBC_A_C: subtract register C and the carry from register A
-            sbc(mRegisters.C);
-            break;
-
-        case 0x9A: // opcode 0x9A, SBC_A_D: subtract D and the carry flag from register A
-            sbc(mRegisters.D);
-            break;
-
-        case 0x9B: // opcode 0x9B, SBC_A_E: subtract E and the carry flag from A
-            sbc(mRegisters.E);
-            break;
-
-        case 0x9C: // opcode 0x9C, SBC_A_H: subtract H and the carry flag from A
-            sbc(mRegisters.H);
-            break;
-
-        case 0x9D: // opcode 0x9D, SBC_A_L: subtract L and the carry flag from A
-            sbc(mRegisters.L);
-            break;
-
-        case 0x9E: // opcode 0x9E, SBC_A_(HL): subtract the value pointed to be HL and the carry flag from register A
-            sbc(mmu->readByte(mRegisters.HL));
-            break;
-
-        case 0x9F: // opcode 0x9F, SBC_A_A: subtract A, the carry flag, and A
-            sbc(mRegisters.A);
-            break;
-           
-        case 0xA0: // opcode 0xA0, AND_B: bitwise AND B against A
-            andB(mRegisters.B);
-            break;
-
-        case 0xA1: // opcode 0xA1, AND_C: bitwise AND C against A
-            andB(mRegisters.C);
-            break;
-
-        case 0xA2: // ocpode 0xA2, AND_D: bitwise D against A
-            andB(mRegisters.D);
-            break;
-
-        case 0xA3: // opcode 0xA3, AND_E: bitwise E against A
-            andB(mRegisters.E);
-            break;
-
-        case 0xA4: // opcode 0xA4, AND_H: bitwise H against A
-            andB(mRegisters.H);
-            break;
-
-        case 0xA5: // opcode 0xA5, AND_L: bitwise L against A
-            andB(mRegisters.L);
-            break;
-
-        case 0xA6: // opcode 0xA6, AND_(HL): bitwise the value in memory pointed to by HL against A
-            andB(mmu->readByte(mRegisters.HL));
-            break;
-
-        case 0xA7: // opcode 0xA7, AND_A: bitwise AND A against A
-            andB(mRegisters.A);
-            break;
-
-        case 0xA8: // opcode 0xA8, XOR_B: bitwise XOR B against A
-            xorB(mRegisters.B);
-            break;
-
-        case 0xA9: // opcode 0xA9, XOR_C: bitwise XOR C against A
-            xorB(mRegisters.C);
-            break;
-
-        case 0xAA: // opcode 0xAA, XOR_D: bitwise XOR D against A
-            xorB(mRegisters.D);
-            break;
-
-        case 0xAB: // opcode 0xAB, XOR_E: bitwise XOR E against A
-            xorB(mRegisters.E);
-            break;
-
-        case 0xAC: // opcode 0xAC, XOR_H: bitwise XOR H against A
-            xorB(mRegisters.H);
-            break;
-
-        case 0xAD: // opcode 0xAD, XOR_L: bitwise XOR L against A
-            xorB(mRegisters.L);
-            break;
-
-        case 0xAE: // opcode 0xAE, XOR_(HL): bitwise XOR the byte in memory pointed to by HL against A
-            xorB(mmu->readByte(mRegisters.HL));
-            break;
-
-        case 0xAF: // opcode 0xAF, XOR_A: bitwise XOR A against A
-            xorB(mRegisters.A);
-            break;
-        
-        case 0xB0: // opcode 0xB0, OR_B: bitwise OR B against A
-            orB(mRegisters.B);
-            break;
-
-        case 0xB1: // opcode 0xB1, OR_C: bitwise OR C against A
-            orB(mRegisters.C);
-            break;
-
-        case 0xB2: // opcode 0xB2, OR_D: bitwise OR D against A
-            orB(mRegisters.D);
-            break;
-
-        case 0xB3: // opcode 0xB3, OR_E: bitwise OR E against A
-            orB(mRegisters.E);
-            break;
-
-        case 0xB4: // opcode 0xB4, OR_H: bitiwse OR H against A
-            orB(mRegisters.H);
-            break;
-
-        case 0xB5: // opcode 0xB5, OR_L: bitwise OR L against A
-            orB(mRegisters.L);
-            break;
-
-        case 0xB6: // opcode 0xB6, OR_(HL): bitwise the byte pointed to in memory by HL against A
-            orB(mmu->readByte(mRegisters.HL));
-            break;
-
-        case 0xB7: // opcode 0xB7, OR_A: bitwise or A against A
-            orB(mRegisters.A);
-            break;
-
-        case 0xB8: // opcode 0xB8, CP_B: compare B against A
-            cp(mRegisters.B);
-            break;
-
-        case 0xB9: // opcode 0xB9, CP_C: compare C against A
-            cp(mRegisters.C);
-            break;
-
-        case 0xBA: // opcode 0xBA, CP_D: compare D against A
-            cp(mRegisters.D);
-            break;
-
-        case 0xBB: // opcode 0xBB, CP_E: compare E against A
-            cp(mRegisters.E);
-            break;
-
-        case 0xBC: // opcode 0xBC, CP_H: compare H against A
-            cp(mRegisters.H);
-            break;
-
-        case 0xBD: // opcode 0xBD, CP_L: compare L against A
-            cp(mRegisters.L);
-            break;
-
-        case 0xBE: // opcode 0xBE, CP_(HL)_A: compare register A and the value pointed to by HL
-            cp(mmu->readByte(mRegisters.HL));
-            break;
-
-        case 0xBF: //0xBF, CP_A: compare A against A
-            cp(mRegisters.A);
-            break;
-
-        case 0xC0: // opcode 0xC0, RET_NZ: return if the last result was not 0
-            if (!mRegisters.isFlagSet(ZERO_FLAG))
-            {
-                ret();
-                mTicks += 20;
-            }
-            else
-                mTicks += 8;
-
-            break;
-
-        case 0xC1: // opcode 0xC1, POP_BC: pop the value from the stack and put it onto register BC
-            mRegisters.BC = popFromStack();
-            break;
-
-        case 0xC2: // opcode 0xC2, JP_NZ_NN: jump the the address NN if the last result was not zero
-            if (!mRegisters.isFlagSet(ZERO_FLAG))
-            {
-                mRegisters.pc = operand;
-                mTicks += 16;
-            }
-            else
-                mTicks += 12;
-            
-            break;
-
-        case 0xC3: // opcode 0xC3, JP_NN: jump to the address NN
-            mRegisters.pc = operand;
-            break;
-
-        case 0xC4: // opcode 0xC4, CALL_NZ_NN: call the subroutine at NN if the last result was not zero
-            if (!mRegisters.isFlagSet(ZERO_FLAG))
-            {
-                call(operand);
-                mTicks += 24;
-            }
-            else
-                mTicks += 12;
-
-            break;
-
-        case 0xC5: // opcode 0xC5, PUSH_BC: push the value of register BC onto the stack
-            pushToStack(mRegisters.BC);
-            break;
-
-        case 0xC6: // opcode 0xC6, ADD_A_N: add N to A
-            mRegisters.A = addB(mRegisters.A, (Byte)operand);
-            break;
-
-        case 0xC7: // opcode 0xC7, RST_0: call the subroutine at 0x0000
-            call(0x0000);
-            break;
-
-        case 0xC8: // opcode 0xC8, RET_Z: return if the last result was zero
-            if (mRegisters.isFlagSet(ZERO_FLAG))
-            {
-                ret();
-                mTicks += 20;
-            }
-            else
-                mTicks += 8;
-            
-            break;
-
-        case 0xC9: // opcode 0xC9, RET: return to calling routine
-            ret();
-            break;
-
-        case 0xCA: // opcode 0xCA, JP_Z_NN: if the last result was zero, jump to the address NN
-            if (mRegisters.isFlagSet(ZERO_FLAG))
-            {
-                mRegisters.pc = operand;
-                mTicks += 16;
-            }
-            else
-                mTicks += 12;
-
-            break;
-
-        case 0xCB: // opcode 0xCB: an opcode of 0xCB means that we will index the extended opcodes table by the operand
-            handleCBOpcodes((Byte)operand);
-            break;
-
-        case 0xCC: // opcode 0xCC, CALL_Z_NN: call the function at NN if the last operation resulted in a zero
-            if (mRegisters.isFlagSet(ZERO_FLAG))
-            {
-                call(operand);
-                mTicks += 24;
-            }
-            else
-                mTicks += 12;
-
-            break;
-
-        case 0xCD: // opcode 0xCD, CALL_NN: call the subroutine at NN
-            call(operand);
-            break;
-
-        case 0xCE: // opcode 0xCE, ADC_A_N: add N and the carry to A
-            addBC((Byte)operand);
-            break;
-
-        case 0xCF: // opcode 0xCF, RST_8: call the subroutine at 0x0008
-            call(0x0008);
-            break;
-
-        case 0xD0: // opcode 0xD0, RET_NC: return if the last result resulted in no carry
-            if (!mRegisters.isFlagSet(CARRY_FLAG))
-            {
-                mTicks += 20;
-                ret();
-            }
-            else
-                mTicks += 8;
-
-            break;
-
-        case 0xD1: // opcode 0xD1, POP_DE: pop the value off the stack and store it into DE
-            mRegisters.DE = popFromStack();
-            break;
-
-        case 0xD2: // opcode 0xD2, JP_NC_NN: jump to NN if the last operation resulted in no carry
-            if (!mRegisters.isFlagSet(CARRY_FLAG))
-            {
-                mTicks += 16;
-                mRegisters.pc = operand;
-            }
-            else
-                mTicks += 12;
-
-            break;
-
-        case 0xD3: // opcode 0xD3: NO INSTRUCTION
-            break;
-
-        case 0xD4: // opcode 0xD4, CALL_NC_NN: call the subroutine at NN if the last operation resulted in no carry
-            if (!mRegisters.isFlagSet(CARRY_FLAG))
-            {
-                call(operand);
-                mTicks += 24;
-            }
-            else
-                mTicks += 12;
-
-            break;
-            
-        case 0xD5: // opcode 0xD5, PUSH_DE: push the value stored at address DE onto the stack
-            pushToStack(mRegisters.DE);
-            break;
-
-        case 0xD6: // opcode 0xD6, SUB_A_N: subtract N from A
-            sub((Byte)operand);
-            break;
-
-        case 0xD7: // opcode 0xD7, RST_10: call the subroutine at 0x0010
-            call(0x0010);
-            break;
-
-        case 0xD8: // opcode 0xD8, RET_C: return if the last operation resulted in a carry
-            if (mRegisters.isFlagSet(CARRY_FLAG))
-            {
-                ret();
-                mTicks += 20;
-            }
-            else
-                mTicks += 8;
-
-            break;
-
-        case 0xD9: // opcode 0xD9, RETI: return to calling routine and enable interrupts
-            ret();
-            mInterruptHandler.enableInterrupts();
-            break;
-
-        case 0xDA: // opcode 0xDA, JP_C_NN: jump to NN if the last operation resulted in a carry
-            if (mRegisters.isFlagSet(CARRY_FLAG))
-            {
-                mTicks += 16;
-                mRegisters.pc = operand;
-            }
-            else
-                mTicks += 12;
-
-            break;
-
-        case 0xDB: // opcode 0xDB: NO INSTRUCTION
-            break;
-            
-        case 0xDC: // opcode 0xDC, CALL_C_NN: call subroutine at NN if the last operation resulted in a carry
-            if (mRegisters.isFlagSet(CARRY_FLAG))
-            {
-                call(operand);
-                mTicks += 24;
-            }
-            else
-                mTicks += 12;
-
-            break;
-
-        case 0xDD: // opcode 0xDD: NO INSTRUCTION
-            break;
-
-        case 0xDE: // opcode 0xDE, SBC_A_N: subtract with carry N from register A
-            sbc((Byte)operand);
-            break;
-
-        case 0xDF: // opcode 0xDF, RST18: run the subroutine at 0x18
-            call(0x18);
-            break;
-
-        case 0xE0: // opcode 0xE0, LDH_N_A: save register A into the memory address pointed to by N + 0xFF00
-            mmu->writeByte((Byte)operand + 0xFF00, mRegisters.A);
-            break;
-
-        case 0xE1: // opcode 0xE1, POP_HL: pop a value from the stack and store it into register HL
-            mRegisters.HL = popFromStack();
-            break;
-
-        case 0xE2: // opcode 0xE2, LDH_C_A: save register A into the memory address pointed to by register C + 0xFF00
-            mmu->writeByte(mRegisters.C + 0xFF00, mRegisters.A);
-            break;
-
-        case 0xE3: // opcode 0xE3, NO INSTRUCTION
-            break;
-
-        case 0xE4: // opcode 0xE4, NO INSTRUCTION
-            break;
-
-        case 0xE5: // opcode 0xE5, PUSH_HL: push the value of HL onto the stack
-            pushToStack(mRegisters.HL);
-            break;
-
-        case 0xE6: // opcode 0xE6, AND_N: bitwise AND N against register A (and store the result in register A)
-            andB((Byte)operand);
-            break;
-
-        case 0xE7: // opcode 0xE7, RST_20: call the subroutine at 0x0020
-            call(0x0020);
-            break;
-
-        case 0xE8: // opcode 0xE8, ADD_SP_N: add 8-bit signed byte N to stack pointer
-            mRegisters.maskFlag(ZERO_FLAG | NEGATIVE_FLAG);
+    // opcode 0x34, INC_(HL): increment the value that HL is pointed at
+    { 0, 12, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeByte(cpu.mState.registers.HL, cpu.incByte(cpu.mmu->readByte(cpu.mState.registers.HL))); } },
+
+    // opcode 0x35, DEC_(HL): decrement the value that HL is pointed at
+    { 0, 12, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeByte(cpu.mState.registers.HL, cpu.decByte(cpu.mmu->readByte(cpu.mState.registers.HL))); } },
+
+    // opcode 0x36, LD_(HL)_N: load the value of N into the memory address that HL is pointed at
+    { 1, 12, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeByte(cpu.mState.registers.HL, (Byte)operand); } },
+
+    // opcode 0x37, SCF: set the carry flag (and clear the negative and half carry flags)
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.setFlag(CARRY_FLAG);
+        cpu.mState.registers.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+    } },
+
+    // opcode 0x38, JR_C_N: relative jump by signed N, if the last result resulted in the carry flag being set
+    { 1, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(CARRY_FLAG))
+        {
+            cpu.mState.registers.pc += (Signedbyte)operand;
+            cpu.mState.ticks += 12;
+        }
+        else
+            cpu.mState.ticks += 8;
+    } },
+
+    // opcode 0x39, ADD_HL_SP: add the value of the stack pointer to HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.HL = cpu.addW(cpu.mState.registers.HL, cpu.mState.registers.sp); } },
+
+    // opcode 0x3A, LDD_A_(HL): load the value of the memory address pointed to by HL into register A, and then decrement HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.A = cpu.mmu->readByte(cpu.mState.registers.HL);
+        cpu.mState.registers.HL--;
+    } },
 
-            if ((mRegisters.sp & 0xFF) + ((Signedbyte)operand & 0xFF) > 0xFF) mRegisters.setFlag(CARRY_FLAG);
-            else                                                              mRegisters.maskFlag(CARRY_FLAG);
-
-            if ((mRegisters.sp & 0xF) + (operand & 0xF) > 0xF) mRegisters.setFlag(HALF_CARRY_FLAG);
-            else                                               mRegisters.maskFlag(HALF_CARRY_FLAG);
+    // opcode 0x3B, DEC_SP: decrement the stack pointer
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.sp--; } },
 
-            mRegisters.sp += (Signedbyte)operand;
+    // opcode 0x3C, INC_A: increment the register A
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = cpu.incByte(cpu.mState.registers.A); } },
 
-            break;
+    // opcode 0x3D, DEC_A: decrement the register A
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = cpu.decByte(cpu.mState.registers.A); } },
 
-        case 0xE9: // opcode 0xE9, JP_(HL): jump to the address stored in the register HL. but many others have this as jumping to the address stored in the register HL?
-            mRegisters.pc = mRegisters.HL; // mmu->readDoubleByte(mRegisters.HL);
-            break;
+    // opcode 0x3E, LD_A_N: load the value of N into register A
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = (Byte)operand; } },
+
+    // opcode 0x3F, CCF: flip the carry flag and clear the negative and half carry flags
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(CARRY_FLAG))
+            cpu.mState.registers.maskFlag(CARRY_FLAG);
+        else
+            cpu.mState.registers.setFlag(CARRY_FLAG);
+
+        cpu.mState.registers.maskFlag(NEGATIVE_FLAG | HALF_CARRY_FLAG);
+    } },
+
+    // opcodes 0x40-0x7F (besides HALT), LD_R_R: load one register (or the value HL points to) into another
+    // these are all generated from the same template, as the opcode's bits select the registers (see CPU::loadRegister)
+    { 0, 4, &CPU::loadRegister<0x40> }, // 0x40, LD_B_B
+    { 0, 4, &CPU::loadRegister<0x41> }, // 0x41, LD_B_C
+    { 0, 4, &CPU::loadRegister<0x42> }, // 0x42, LD_B_D
+    { 0, 4, &CPU::loadRegister<0x43> }, // 0x43, LD_B_E
+    { 0, 4, &CPU::loadRegister<0x44> }, // 0x44, LD_B_H
+    { 0, 4, &CPU::loadRegister<0x45> }, // 0x45, LD_B_L
+    { 0, 8, &CPU::loadRegister<0x46> }, // 0x46, LD_B_(HL)
+    { 0, 4, &CPU::loadRegister<0x47> }, // 0x47, LD_B_A
+    { 0, 4, &CPU::loadRegister<0x48> }, // 0x48, LD_C_B
+    { 0, 4, &CPU::loadRegister<0x49> }, // 0x49, LD_C_C
+    { 0, 4, &CPU::loadRegister<0x4A> }, // 0x4A, LD_C_D
+    { 0, 4, &CPU::loadRegister<0x4B> }, // 0x4B, LD_C_E
+    { 0, 4, &CPU::loadRegister<0x4C> }, // 0x4C, LD_C_H
+    { 0, 4, &CPU::loadRegister<0x4D> }, // 0x4D, LD_C_L
+    { 0, 8, &CPU::loadRegister<0x4E> }, // 0x4E, LD_C_(HL)
+    { 0, 4, &CPU::loadRegister<0x4F> }, // 0x4F, LD_C_A
+    { 0, 4, &CPU::loadRegister<0x50> }, // 0x50, LD_D_B
+    { 0, 4, &CPU::loadRegister<0x51> }, // 0x51, LD_D_C
+    { 0, 4, &CPU::loadRegister<0x52> }, // 0x52, LD_D_D
+    { 0, 4, &CPU::loadRegister<0x53> }, // 0x53, LD_D_E
+    { 0, 4, &CPU::loadRegister<0x54> }, // 0x54, LD_D_H
+    { 0, 4, &CPU::loadRegister<0x55> }, // 0x55, LD_D_L
+    { 0, 8, &CPU::loadRegister<0x56> }, // 0x56, LD_D_(HL)
+    { 0, 4, &CPU::loadRegister<0x57> }, // 0x57, LD_D_A
+    { 0, 4, &CPU::loadRegister<0x58> }, // 0x58, LD_E_B
+    { 0, 4, &CPU::loadRegister<0x59> }, // 0x59, LD_E_C
+    { 0, 4, &CPU::loadRegister<0x5A> }, // 0x5A, LD_E_D
+    { 0, 4, &CPU::loadRegister<0x5B> }, // 0x5B, LD_E_E
+    { 0, 4, &CPU::loadRegister<0x5C> }, // 0x5C, LD_E_H
+    { 0, 4, &CPU::loadRegister<0x5D> }, // 0x5D, LD_E_L
+    { 0, 8, &CPU::loadRegister<0x5E> }, // 0x5E, LD_E_(HL)
+    { 0, 4, &CPU::loadRegister<0x5F> }, // 0x5F, LD_E_A
+    { 0, 4, &CPU::loadRegister<0x60> }, // 0x60, LD_H_B
+    { 0, 4, &CPU::loadRegister<0x61> }, // 0x61, LD_H_C
+    { 0, 4, &CPU::loadRegister<0x62> }, // 0x62, LD_H_D
+    { 0, 4, &CPU::loadRegister<0x63> }, // 0x63, LD_H_E
+    { 0, 4, &CPU::loadRegister<0x64> }, // 0x64, LD_H_H
+    { 0, 4, &CPU::loadRegister<0x65> }, // 0x65, LD_H_L
+    { 0, 8, &CPU::loadRegister<0x66> }, // 0x66, LD_H_(HL)
+    { 0, 4, &CPU::loadRegister<0x67> }, // 0x67, LD_H_A
+    { 0, 4, &CPU::loadRegister<0x68> }, // 0x68, LD_L_B
+    { 0, 4, &CPU::loadRegister<0x69> }, // 0x69, LD_L_C
+    { 0, 4, &CPU::loadRegister<0x6A> }, // 0x6A, LD_L_D
+    { 0, 4, &CPU::loadRegister<0x6B> }, // 0x6B, LD_L_E
+    { 0, 4, &CPU::loadRegister<0x6C> }, // 0x6C, LD_L_H
+    { 0, 4, &CPU::loadRegister<0x6D> }, // 0x6D, LD_L_L
+    { 0, 8, &CPU::loadRegister<0x6E> }, // 0x6E, LD_L_(HL)
+    { 0, 4, &CPU::loadRegister<0x6F> }, // 0x6F, LD_L_A
+    { 0, 8, &CPU::loadRegister<0x70> }, // 0x70, LD_(HL)_B
+    { 0, 8, &CPU::loadRegister<0x71> }, // 0x71, LD_(HL)_C
+    { 0, 8, &CPU::loadRegister<0x72> }, // 0x72, LD_(HL)_D
+    { 0, 8, &CPU::loadRegister<0x73> }, // 0x73, LD_(HL)_E
+    { 0, 8, &CPU::loadRegister<0x74> }, // 0x74, LD_(HL)_H
+    { 0, 8, &CPU::loadRegister<0x75> }, // 0x75, LD_(HL)_L
+
+    // opcode 0x76, HALT: stop exeuction until an interrupt occurs
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.halted = !cpu.mState.pendingInterrupts;
+
+        if (!cpu.mState.halted)
+            cpu.mState.registers.pc++;
+        else
+            // we decrement the pc here because we automatically increment it after fetching the opcode
+            // but, when the CPU is in a halted state, we want to stay at the exact same HALT opcode
+            // until an interrupt has occured (the CPU skips ahead to that in runHalted)
+            cpu.mState.registers.pc--;
+    } },
+
+    { 0, 8, &CPU::loadRegister<0x77> }, // 0x77, LD_(HL)_A
+    { 0, 4, &CPU::loadRegister<0x78> }, // 0x78, LD_A_B
+    { 0, 4, &CPU::loadRegister<0x79> }, // 0x79, LD_A_C
+    { 0, 4, &CPU::loadRegister<0x7A> }, // 0x7A, LD_A_D
+    { 0, 4, &CPU::loadRegister<0x7B> }, // 0x7B, LD_A_E
+    { 0, 4, &CPU::loadRegister<0x7C> }, // 0x7C, LD_A_H
+    { 0, 4, &CPU::loadRegister<0x7D> }, // 0x7D, LD_A_L
+    { 0, 8, &CPU::loadRegister<0x7E> }, // 0x7E, LD_A_(HL)
+    { 0, 4, &CPU::loadRegister<0x7F> }, // 0x7F, LD_A_A
+
+    // opcodes 0x80-0xBF, ADD/ADC/SUB/SBC/AND/XOR/OR/CP: apply an operation to register A and another register (or the value HL points to)
+    // these are all generated from the same template, as the opcode's bits select the operation and the register (see CPU::aluRegister)
+    { 0, 4, &CPU::aluRegister<0x80> }, // 0x80, ADD_A_B
+    { 0, 4, &CPU::aluRegister<0x81> }, // 0x81, ADD_A_C
+    { 0, 4, &CPU::aluRegister<0x82> }, // 0x82, ADD_A_D
+    { 0, 4, &CPU::aluRegister<0x83> }, // 0x83, ADD_A_E
+    { 0, 4, &CPU::aluRegister<0x84> }, // 0x84, ADD_A_H
+    { 0, 4, &CPU::aluRegister<0x85> }, // 0x85, ADD_A_L
+    { 0, 8, &CPU::aluRegister<0x86> }, // 0x86, ADD_A_(HL)
+    { 0, 4, &CPU::aluRegister<0x87> }, // 0x87, ADD_A_A
+    { 0, 4, &CPU::aluRegister<0x88> }, // 0x88, ADC_A_B
+    { 0, 4, &CPU::aluRegister<0x89> }, // 0x89, ADC_A_C
+    { 0, 4, &CPU::aluRegister<0x8A> }, // 0x8A, ADC_A_D
+    { 0, 4, &CPU::aluRegister<0x8B> }, // 0x8B, ADC_A_E
+    { 0, 4, &CPU::aluRegister<0x8C> }, // 0x8C, ADC_A_H
+    { 0, 4, &CPU::aluRegister<0x8D> }, // 0x8D, ADC_A_L
+    { 0, 8, &CPU::aluRegister<0x8E> }, // 0x8E, ADC_A_(HL)
+    { 0, 4, &CPU::aluRegister<0x8F> }, // 0x8F, ADC_A_A
+    { 0, 4, &CPU::aluRegister<0x90> }, // 0x90, SUB_A_B
+    { 0, 4, &CPU::aluRegister<0x91> }, // 0x91, SUB_A_C
+    { 0, 4, &CPU::aluRegister<0x92> }, // 0x92, SUB_A_D
+    { 0, 4, &CPU::aluRegister<0x93> }, // 0x93, SUB_A_E
+    { 0, 4, &CPU::aluRegister<0x94> }, // 0x94, SUB_A_H
+    { 0, 4, &CPU::aluRegister<0x95> }, // 0x95, SUB_A_L
+    { 0, 8, &CPU::aluRegister<0x96> }, // 0x96, SUB_A_(HL)
+    { 0, 4, &CPU::aluRegister<0x97> }, // 0x97, SUB_A_A
+    { 0, 4, &CPU::aluRegister<0x98> }, // 0x98, SBC_A_B
+    { 0, 4, &CPU::aluRegister<0x99> }, // 0x99, SBC_A_C
+    { 0, 4, &CPU::aluRegister<0x9A> }, // 0x9A, SBC_A_D
+    { 0, 4, &CPU::aluRegister<0x9B> }, // 0x9B, SBC_A_E
+    { 0, 4, &CPU::aluRegister<0x9C> }, // 0x9C, SBC_A_H
+    { 0, 4, &CPU::aluRegister<0x9D> }, // 0x9D, SBC_A_L
+    { 0, 8, &CPU::aluRegister<0x9E> }, // 0x9E, SBC_A_(HL)
+    { 0, 4, &CPU::aluRegister<0x9F> }, // 0x9F, SBC_A_A
+    { 0, 4, &CPU::aluRegister<0xA0> }, // 0xA0, AND_B
+    { 0, 4, &CPU::aluRegister<0xA1> }, // 0xA1, AND_C
+    { 0, 4, &CPU::aluRegister<0xA2> }, // 0xA2, AND_D
+    { 0, 4, &CPU::aluRegister<0xA3> }, // 0xA3, AND_E
+    { 0, 4, &CPU::aluRegister<0xA4> }, // 0xA4, AND_H
+    { 0, 4, &CPU::aluRegister<0xA5> }, // 0xA5, AND_L
+    { 0, 8, &CPU::aluRegister<0xA6> }, // 0xA6, AND_(HL)
+    { 0, 4, &CPU::aluRegister<0xA7> }, // 0xA7, AND_A
+    { 0, 4, &CPU::aluRegister<0xA8> }, // 0xA8, XOR_B
+    { 0, 4, &CPU::aluRegister<0xA9> }, // 0xA9, XOR_C
+    { 0, 4, &CPU::aluRegister<0xAA> }, // 0xAA, XOR_D
+    { 0, 4, &CPU::aluRegister<0xAB> }, // 0xAB, XOR_E
+    { 0, 4, &CPU::aluRegister<0xAC> }, // 0xAC, XOR_H
+    { 0, 4, &CPU::aluRegister<0xAD> }, // 0xAD, XOR_L
+    { 0, 8, &CPU::aluRegister<0xAE> }, // 0xAE, XOR_(HL)
+    { 0, 4, &CPU::aluRegister<0xAF> }, // 0xAF, XOR_A
+    { 0, 4, &CPU::aluRegister<0xB0> }, // 0xB0, OR_B
+    { 0, 4, &CPU::aluRegister<0xB1> }, // 0xB1, OR_C
+    { 0, 4, &CPU::aluRegister<0xB2> }, // 0xB2, OR_D
+    { 0, 4, &CPU::aluRegister<0xB3> }, // 0xB3, OR_E
+    { 0, 4, &CPU::aluRegister<0xB4> }, // 0xB4, OR_H
+    { 0, 4, &CPU::aluRegister<0xB5> }, // 0xB5, OR_L
+    { 0, 8, &CPU::aluRegister<0xB6> }, // 0xB6, OR_(HL)
+    { 0, 4, &CPU::aluRegister<0xB7> }, // 0xB7, OR_A
+    { 0, 4, &CPU::aluRegister<0xB8> }, // 0xB8, CP_B
+    { 0, 4, &CPU::aluRegister<0xB9> }, // 0xB9, CP_C
+    { 0, 4, &CPU::aluRegister<0xBA> }, // 0xBA, CP_D
+    { 0, 4, &CPU::aluRegister<0xBB> }, // 0xBB, CP_E
+    { 0, 4, &CPU::aluRegister<0xBC> }, // 0xBC, CP_H
+    { 0, 4, &CPU::aluRegister<0xBD> }, // 0xBD, CP_L
+    { 0, 8, &CPU::aluRegister<0xBE> }, // 0xBE, CP_(HL)_A
+    { 0, 4, &CPU::aluRegister<0xBF> }, // 0xBF, CP_A
+
+    // opcode 0xC0, RET_NZ: return if the last result was not 0
+    { 0, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (!cpu.mState.registers.isFlagSet(ZERO_FLAG))
+        {
+            cpu.ret();
+            cpu.mState.ticks += 20;
+        }
+        else
+            cpu.mState.ticks += 8;
+    } },
+
+    // opcode 0xC1, POP_BC: pop the value from the stack and put it onto register BC
+    { 0, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.BC = cpu.popFromStack(); } },
+
+    // opcode 0xC2, JP_NZ_NN: jump the the address NN if the last result was not zero
+    { 2, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (!cpu.mState.registers.isFlagSet(ZERO_FLAG))
+        {
+            cpu.mState.registers.pc = operand;
+            cpu.mState.ticks += 16;
+        }
+        else
+            cpu.mState.ticks += 12;
+    } },
+
+    // opcode 0xC3, JP_NN: jump to the address NN
+    { 2, 16, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.pc = operand; } },
+
+    // opcode 0xC4, CALL_NZ_NN: call the subroutine at NN if the last result was not zero
+    { 2, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (!cpu.mState.registers.isFlagSet(ZERO_FLAG))
+        {
+            cpu.call(operand);
+            cpu.mState.ticks += 24;
+        }
+        else
+            cpu.mState.ticks += 12;
+    } },
+
+    // opcode 0xC5, PUSH_BC: push the value of register BC onto the stack
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.pushToStack(cpu.mState.registers.BC); } },
+
+    // opcode 0xC6, ADD_A_N: add N to A
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = cpu.addB(cpu.mState.registers.A, (Byte)operand); } },
+
+    // opcode 0xC7, RST_0: call the subroutine at 0x0000
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.call(0x0000); } },
+
+    // opcode 0xC8, RET_Z: return if the last result was zero
+    { 0, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(ZERO_FLAG))
+        {
+            cpu.ret();
+            cpu.mState.ticks += 20;
+        }
+        else
+            cpu.mState.ticks += 8;
+    } },
+
+    // opcode 0xC9, RET: return to calling routine
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.ret(); } },
+
+    // opcode 0xCA, JP_Z_NN: if the last result was zero, jump to the address NN
+    { 2, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(ZERO_FLAG))
+        {
+            cpu.mState.registers.pc = operand;
+            cpu.mState.ticks += 16;
+        }
+        else
+            cpu.mState.ticks += 12;
+    } },
+
+    // opcode 0xCB: an opcode of 0xCB means that we will index the extended opcodes table by the operand
+    { 1, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        const Opcode& cbOpcode = CB_OPCODES[(Byte)operand];
+
+        // add the number of ticks the CB-prefixed opcode will take
+        cpu.mState.ticks += cbOpcode.ticks;
+        cbOpcode.handler(cpu, operand);
+    } },
+
+    // opcode 0xCC, CALL_Z_NN: call the function at NN if the last operation resulted in a zero
+    { 2, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(ZERO_FLAG))
+        {
+            cpu.call(operand);
+            cpu.mState.ticks += 24;
+        }
+        else
+            cpu.mState.ticks += 12;
+    } },
+
+    // opcode 0xCD, CALL_NN: call the subroutine at NN
+    { 2, 24, [](CPU& cpu, DoubleByte operand) { cpu.call(operand); } },
+
+    // opcode 0xCE, ADC_A_N: add N and the carry to A
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.addBC((Byte)operand); } },
+
+    // opcode 0xCF, RST_8: call the subroutine at 0x0008
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.call(0x0008); } },
+
+    // opcode 0xD0, RET_NC: return if the last result resulted in no carry
+    { 0, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (!cpu.mState.registers.isFlagSet(CARRY_FLAG))
+        {
+            cpu.mState.ticks += 20;
+            cpu.ret();
+        }
+        else
+            cpu.mState.ticks += 8;
+    } },
+
+    // opcode 0xD1, POP_DE: pop the value off the stack and store it into DE
+    { 0, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.DE = cpu.popFromStack(); } },
+
+    // opcode 0xD2, JP_NC_NN: jump to NN if the last operation resulted in no carry
+    { 2, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (!cpu.mState.registers.isFlagSet(CARRY_FLAG))
+        {
+            cpu.mState.ticks += 16;
+            cpu.mState.registers.pc = operand;
+        }
+        else
+            cpu.mState.ticks += 12;
+    } },
+
+    // opcode 0xD3: NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xD4, CALL_NC_NN: call the subroutine at NN if the last operation resulted in no carry
+    { 2, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (!cpu.mState.registers.isFlagSet(CARRY_FLAG))
+        {
+            cpu.call(operand);
+            cpu.mState.ticks += 24;
+        }
+        else
+            cpu.mState.ticks += 12;
+    } },
+
+    // opcode 0xD5, PUSH_DE: push the value stored at address DE onto the stack
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.pushToStack(cpu.mState.registers.DE); } },
+
+    // opcode 0xD6, SUB_A_N: subtract N from A
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.sub((Byte)operand); } },
+
+    // opcode 0xD7, RST_10: call the subroutine at 0x0010
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.call(0x0010); } },
+
+    // opcode 0xD8, RET_C: return if the last operation resulted in a carry
+    { 0, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(CARRY_FLAG))
+        {
+            cpu.ret();
+            cpu.mState.ticks += 20;
+        }
+        else
+            cpu.mState.ticks += 8;
+    } },
+
+    // opcode 0xD9, RETI: return to calling routine and enable interrupts
+    { 0, 16, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.ret();
+        cpu.enableInterrupts();
+    } },
+
+    // opcode 0xDA, JP_C_NN: jump to NN if the last operation resulted in a carry
+    { 2, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(CARRY_FLAG))
+        {
+            cpu.mState.ticks += 16;
+            cpu.mState.registers.pc = operand;
+        }
+        else
+            cpu.mState.ticks += 12;
+    } },
+
+    // opcode 0xDB: NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xDC, CALL_C_NN: call subroutine at NN if the last operation resulted in a carry
+    { 2, 0, [](CPU& cpu, DoubleByte operand)
+    {
+        if (cpu.mState.registers.isFlagSet(CARRY_FLAG))
+        {
+            cpu.call(operand);
+            cpu.mState.ticks += 24;
+        }
+        else
+            cpu.mState.ticks += 12;
+    } },
 
-        case 0xEA: // opcode 0xEA, LD_NN_A: store the value of register A into memory address NN
-            mmu->writeByte(operand, mRegisters.A);
-            break;
+    // opcode 0xDD: NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
 
-        case 0xEB: // opcode 0xEB: NO INSTRUCTION
-            break;
+    // opcode 0xDE, SBC_A_N: subtract with carry N from register A
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.sbc((Byte)operand); } },
 
-        case 0xEC: // opcode 0xEC: NO INSTRUCTION
-            break;
+    // opcode 0xDF, RST18: run the subroutine at 0x18
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.call(0x18); } },
 
-        case 0xED: // opcode 0xED: NO INSTRUCTION
-            break;
+    // opcode 0xE0, LDH_N_A: save register A into the memory address pointed to by N + 0xFF00
+    { 1, 12, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeByte((Byte)operand + 0xFF00, cpu.mState.registers.A); } },
 
-        case 0xEE: // opcode 0xEE, XOR_N: bitwise XOR N against A
-            xorB((Byte)operand);
-            break;
+    // opcode 0xE1, POP_HL: pop a value from the stack and store it into register HL
+    { 0, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.HL = cpu.popFromStack(); } },
 
-        case 0xEF: // opcode 0xEF, RST_28: call the subroutine at 0x0028
-            call(0x28);
-            break;
+    // opcode 0xE2, LDH_C_A: save register A into the memory address pointed to by register C + 0xFF00
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeByte(cpu.mState.registers.C + 0xFF00, cpu.mState.registers.A); } },
 
-        case 0xF0: // opcode 0xF0, LDH_A_N: store the value of memory address N + 0xFF00 into register A
-            mRegisters.A = mmu->readByte((Byte)operand + 0xFF00);
-            break;
+    // opcode 0xE3, NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xE4, NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xE5, PUSH_HL: push the value of HL onto the stack
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.pushToStack(cpu.mState.registers.HL); } },
+
+    // opcode 0xE6, AND_N: bitwise AND N against register A (and store the result in register A)
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.andB((Byte)operand); } },
+
+    // opcode 0xE7, RST_20: call the subroutine at 0x0020
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.call(0x0020); } },
+
+    // opcode 0xE8, ADD_SP_N: add 8-bit signed byte N to stack pointer
+    { 1, 16, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.maskFlag(ZERO_FLAG | NEGATIVE_FLAG);
+
+        if ((cpu.mState.registers.sp & 0xFF) + ((Signedbyte)operand & 0xFF) > 0xFF) cpu.mState.registers.setFlag(CARRY_FLAG);
+        else                                                              cpu.mState.registers.maskFlag(CARRY_FLAG);
+
+        if ((cpu.mState.registers.sp & 0xF) + (operand & 0xF) > 0xF) cpu.mState.registers.setFlag(HALF_CARRY_FLAG);
+        else                                               cpu.mState.registers.maskFlag(HALF_CARRY_FLAG);
+
+        cpu.mState.registers.sp += (Signedbyte)operand;
+    } },
+
+    // opcode 0xE9, JP_(HL): jump to the address stored in the register HL. but many others have this as jumping to the address stored in the register HL?
+    { 0, 4, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.pc = cpu.mState.registers.HL; // cpu.mmu->readDoubleByte(cpu.mState.registers.HL);
+    } },
+
+    // opcode 0xEA, LD_NN_A: store the value of register A into memory address NN
+    { 2, 16, [](CPU& cpu, DoubleByte operand) { cpu.mmu->writeByte(operand, cpu.mState.registers.A); } },
+
+    // opcode 0xEB: NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xEC: NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xED: NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xEE, XOR_N: bitwise XOR N against A
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.xorB((Byte)operand); } },
+
+    // opcode 0xEF, RST_28: call the subroutine at 0x0028
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.call(0x28); } },
+
+    // opcode 0xF0, LDH_A_N: store the value of memory address N + 0xFF00 into register A
+    { 1, 12, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = cpu.mmu->readByte((Byte)operand + 0xFF00); } },
+
+    // opcode 0xF1, POP_AF: pop the value off the stack and store it into AF
+    { 0, 12, [](CPU& cpu, DoubleByte operand)
+    {
+        // any pending flags have to be dealt with first, otherwise they would later overwrite the popped flags
+        cpu.mState.registers.resolveFlags();
+        cpu.mState.registers.AF = cpu.popFromStack();
+
+        // in case the flag register had its 4 lower bits set
+        cpu.mState.registers.F &= ~0xF;
+    } },
+
+    // opcode 0xF2, LD_A_(C): load A with the value pointed to in memory by 0xFF00 + C
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = cpu.mmu->readByte(cpu.mState.registers.C + 0xFF00); } },
+
+    // opcode 0xF3, DI: disable interrupts
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.mInterruptHandler.disableInterrupts(); } },
+
+    // opcode 0xF4: NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xF5, PUSH_AF: push the value of register AF onto the stack
+    { 0, 16, [](CPU& cpu, DoubleByte operand)
+    {
+        // any pending flags have to be worked out before F is pushed
+        cpu.mState.registers.resolveFlags();
+        cpu.pushToStack(cpu.mState.registers.AF);
+    } },
+
+    // opcode 0xF6, OR_N: bitwise N against A
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.orB((Byte)operand); } },
+
+    // opcode 0xF7, RST_30: call the subroutine at 0x0030
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.call(0x0030); } },
+
+    // opcode 0xF8, LDHL_SP_N: add 8-bit signed byte to stack pointer and save the result in HL
+    { 1, 12, [](CPU& cpu, DoubleByte operand)
+    {
+        cpu.mState.registers.maskFlag(ZERO_FLAG | NEGATIVE_FLAG);
         
-        case 0xF1: // opcode 0xF1, POP_AF: pop the value off the stack and store it into AF
-            mRegisters.AF = popFromStack();
-
-            // in case the flag register had its 4 lower bits set
-            mRegisters.F &= ~0xF;
-            break;
-
-        case 0xF2: // opcode 0xF2, LD_A_(C): load A with the value pointed to in memory by 0xFF00 + C
-            mRegisters.A = mmu->readByte(mRegisters.C + 0xFF00);
-            break;
-
-        case 0xF3: // opcode 0xF3, DI: disable interrupts
-            mInterruptHandler.disableInterrupts();
-            break;
-
-        case 0xF4: // opcode 0xF4: NO INSTRUCTION
-            break;
-
-        case 0xF5: // opcode 0xF5, PUSH_AF: push the value of register AF onto the stack
-            pushToStack(mRegisters.AF);
-            break;
-
-        case 0xF6: // opcode 0xF6, OR_N: bitwise N against A
-            orB((Byte)operand);
-            break;
-
-        case 0xF7: // opcode 0xF7, RST_30: call the subroutine at 0x0030
-            call(0x0030);
-            break;
-
-        case 0xF8: // opcode 0xF8, LDHL_SP_N: add 8-bit signed byte to stack pointer and save the result in HL
-            mRegisters.maskFlag(ZERO_FLAG | NEGATIVE_FLAG);
-            
-            if ((mRegisters.sp & 0xFF) + ((Signedbyte)operand & 0xFF) > 0xFF) mRegisters.setFlag(CARRY_FLAG);
-            else                                                              mRegisters.maskFlag(CARRY_FLAG);
-            
-            if ((mRegisters.sp & 0xF) + (operand & 0xF) > 0xF) mRegisters.setFlag(HALF_CARRY_FLAG);
-            else                                               mRegisters.maskFlag(HALF_CARRY_FLAG);
-
-            mRegisters.HL = mRegisters.sp + (Signedbyte)operand;
-            break;
-
-        case 0xF9: // opcode 0xF9, LD_SP_HL: set the stack pointer to HL
-            mRegisters.sp = mRegisters.HL;
-            break;
-
-        case 0xFA: // opcode 0xFA, LD_A_NN: load register A with the value pointed to in memory by NN
-            mRegisters.A = mmu->readByte(operand);
-            break;
-
-        case 0xFB: // opcode 0xFB, EI: enable interrupts
-            mInterruptHandler.enableInterrupts();
-            break;
-
-        case 0xFC: // opcode 0xFC: NO INSTRCTION
-            break;
-
-        case 0xFD: // opcode 0xFD: NO INSTRUCTION
-            break;
-
-        case 0xFE: // opcode 0xFE, CP_N: compare the value of register A against N
-            cp((Byte)operand);
-            break;
-
-        case 0xFF: // opcode 0xFF, RST_38: call the subroutine at 0x38 
-            call(0x38);
-            break;
-
-        default: 
-            std::cout << "unknown opcode: 0x" << std::hex << (int)opcode << std::endl;
-            std::cout << "pc: " << mRegisters.pc << std::endl;
-            exit(5);
-    }
-}
\ No newline at end of file
+        if ((cpu.mState.registers.sp & 0xFF) + ((Signedbyte)operand & 0xFF) > 0xFF) cpu.mState.registers.setFlag(CARRY_FLAG);
+        else                                                              cpu.mState.registers.maskFlag(CARRY_FLAG);
+        
+        if ((cpu.mState.registers.sp & 0xF) + (operand & 0xF) > 0xF) cpu.mState.registers.setFlag(HALF_CARRY_FLAG);
+        else                                               cpu.mState.registers.maskFlag(HALF_CARRY_FLAG);
+
+        cpu.mState.registers.HL = cpu.mState.registers.sp + (Signedbyte)operand;
+    } },
+
+    // opcode 0xF9, LD_SP_HL: set the stack pointer to HL
+    { 0, 8, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.sp = cpu.mState.registers.HL; } },
+
+    // opcode 0xFA, LD_A_NN: load register A with the value pointed to in memory by NN
+    { 2, 16, [](CPU& cpu, DoubleByte operand) { cpu.mState.registers.A = cpu.mmu->readByte(operand); } },
+
+    // opcode 0xFB, EI: enable interrupts
+    { 0, 4, [](CPU& cpu, DoubleByte operand) { cpu.enableInterrupts(); } },
+
+    // opcode 0xFC: NO INSTRCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xFD: NO INSTRUCTION
+    { 0, 0, [](CPU& cpu, DoubleByte operand) {} },
+
+    // opcode 0xFE, CP_N: compare the value of register A against N
+    { 1, 8, [](CPU& cpu, DoubleByte operand) { cpu.cp((Byte)operand); } },
+
+    // opcode 0xFF, RST_38: call the subroutine at 0x38
+    { 0, 16, [](CPU& cpu, DoubleByte operand) { cpu.call(0x38); } },
+};
\ No newline at end of file
@@ -0,0 +1,145 @@
+#include "CPU.h"
+
+/*
+    superinstructions run a common sequence of instructions with a single dispatch, and can use what they already know about the
+    earlier instructions (like the result of a comparison) instead of working it out from the flags again. each instruction in the
+    sequence still adds its own ticks and lets the rest of the gameboy catch up afterwards, exactly like it would if it had been ran
+    on its own, so the timing is the same. the sequences were picked with the opcode profiler (see OpcodeProfiler.h)
+*/
+
+// LDH_A_N, CP_N, then JR_NZ_N or JR_Z_N: waiting for an i/o register (usually LY) to hold a certain value
+template<Byte jumpOpcode>
+bool CPU::pollLoop(CPU& cpu, const MicroOp* ops, uint64_t maxTicks, uint32_t version)
+{
+    // opcode 0xF0, LDH_A_N
+    cpu.mState.registers.pc += 2;
+    cpu.mState.ticks += 12;
+    cpu.mState.registers.A = cpu.mmu->readByte((Byte)ops[0].operand + 0xFF00);
+
+    if (!cpu.finishInstruction(0xF0, 12, cpu.mState.registers.pc, maxTicks, version))
+        return false;
+
+    // opcode 0xFE, CP_N
+    cpu.mState.registers.pc += 2;
+    cpu.mState.ticks += 8;
+    cpu.cp((Byte)ops[1].operand);
+
+    bool zero = cpu.mState.registers.A == (Byte)ops[1].operand;
+
+    if (!cpu.finishInstruction(0xFE, 8, cpu.mState.registers.pc, maxTicks, version))
+        return false;
+
+    // opcode 0x20 or 0x28, JR_NZ_N or JR_Z_N. the zero flag is already known from the comparison
+    cpu.mState.registers.pc += 2;
+    int ticks = 8;
+
+    if (zero == (jumpOpcode == 0x28))
+    {
+        cpu.mState.registers.pc += (Signedbyte)ops[2].operand;
+        ticks = 12;
+    }
+
+    cpu.mState.ticks += ticks;
+    return cpu.finishInstruction(jumpOpcode, ticks, cpu.mState.registers.pc, maxTicks, version);
+}
+
+// LDI_A_HL then LD_DE_A: copying a byte from where HL points to where DE points
+bool CPU::copyLoop(CPU& cpu, const MicroOp* ops, uint64_t maxTicks, uint32_t version)
+{
+    // opcode 0x2A, LDI_A_HL
+    cpu.mState.registers.pc += 1;
+    cpu.mState.ticks += 8;
+    cpu.mState.registers.A = cpu.mmu->readByte(cpu.mState.registers.HL);
+    cpu.mState.registers.HL++;
+
+    if (!cpu.finishInstruction(0x2A, 8, cpu.mState.registers.pc, maxTicks, version))
+        return false;
+
+    // opcode 0x12, LD_DE_A
+    cpu.mState.registers.pc += 1;
+    cpu.mState.ticks += 8;
+    cpu.mmu->writeByte(cpu.mState.registers.DE, cpu.mState.registers.A);
+
+    return cpu.finishInstruction(0x12, 8, cpu.mState.registers.pc, maxTicks, version);
+}
+
+// DEC_R then JR_NZ_N: a loop counting a register down to 0
+template<Byte decOpcode>
+bool CPU::decrementLoop(CPU& cpu, const MicroOp* ops, uint64_t maxTicks, uint32_t version)
+{
+    // the register is selected by bits 3-5 of the opcode, like the other register opcodes
+    constexpr Byte reg = decOpcode >> 3;
+
+    // DEC_R
+    cpu.mState.registers.pc += 1;
+    cpu.mState.ticks += 4;
+
+    Byte val = cpu.decByte(cpu.readRegister<reg>());
+    cpu.writeRegister<reg>(val);
+
+    if (!cpu.finishInstruction(decOpcode, 4, cpu.mState.registers.pc, maxTicks, version))
+        return false;
+
+    // opcode 0x20, JR_NZ_N. the zero flag is already known from the decremented value
+    cpu.mState.registers.pc += 2;
+    int ticks = 8;
+
+    if (val != 0)
+    {
+        cpu.mState.registers.pc += (Signedbyte)ops[1].operand;
+        ticks = 12;
+    }
+
+    cpu.mState.ticks += ticks;
+    return cpu.finishInstruction(0x20, ticks, cpu.mState.registers.pc, maxTicks, version);
+}
+
+// every sequence that has a superinstruction, checked in this order
+const CPU::Superinstruction CPU::SUPERINSTRUCTIONS[8] =
+{
+    { 3, { 0xF0, 0xFE, 0x20 }, &CPU::pollLoop<0x20> },
+    { 3, { 0xF0, 0xFE, 0x28 }, &CPU::pollLoop<0x28> },
+    { 2, { 0x2A, 0x12 },       &CPU::copyLoop },
+    { 2, { 0x05, 0x20 },       &CPU::decrementLoop<0x05> }, // DEC_B
+    { 2, { 0x0D, 0x20 },       &CPU::decrementLoop<0x0D> }, // DEC_C
+    { 2, { 0x15, 0x20 },       &CPU::decrementLoop<0x15> }, // DEC_D
+    { 2, { 0x1D, 0x20 },       &CPU::decrementLoop<0x1D> }, // DEC_E
+    { 2, { 0x3D, 0x20 },       &CPU::decrementLoop<0x3D> }, // DEC_A
+};
+
+// puts a superinstruction in front of every sequence in the block that has one. the sequence's own instructions stay where they are,
+// so the superinstruction can read their operands (and so the JIT, which has no use for superinstructions, can simply skip it)
+void CPU::fuseSuperinstructions(Block& block)
+{
+    std::vector<MicroOp> ops;
+
+    for (size_t index = 0; index < block.ops.size(); index++)
+    {
+        for (const Superinstruction& superinstruction : SUPERINSTRUCTIONS)
+        {
+            if (index + superinstruction.length > block.ops.size())
+                continue;
+
+            bool matches = true;
+            for (int part = 0; part < superinstruction.length; part++)
+                matches = matches && block.ops[index + part].opcode == superinstruction.opcodes[part];
+
+            if (!matches)
+                continue;
+
+            MicroOp op = {};
+            op.superinstruction = superinstruction.handler;
+            op.fusedOps = superinstruction.length;
+            ops.push_back(op);
+
+            // copy the sequence over as is, without trying to start another superinstruction in the middle of it
+            for (int part = 0; part < superinstruction.length - 1; part++)
+                ops.push_back(block.ops[index++]);
+            break;
+        }
+
+        ops.push_back(block.ops[index]);
+    }
+
+    block.ops = std::move(ops);
+}